@@ -0,0 +1,61 @@
+#include <coco/runtime.hpp>
+#include <coco/sync.hpp>
+
+#include <algorithm>
+#include <cstdio>
+
+// timer lateness while the workers chew through bursts of ready tasks, with and without the cooperative budget.
+// A single worker makes the bursts and the timer share a queue.
+constexpr auto kThreadCount = 1;
+constexpr auto kBurst = 100'000;
+constexpr auto kBursts = 20;
+constexpr auto kTick = std::chrono::microseconds(200);
+
+auto busyTask(coco::sync::Latch& latch) -> coco::Task<>
+{
+  auto start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start < std::chrono::nanoseconds(500)) {
+  }
+  latch.countDown();
+  co_return;
+}
+
+auto ticker(coco::Runtime& rt, std::atomic_bool& done, std::vector<std::chrono::nanoseconds>& lateness)
+    -> coco::Task<>
+{
+  while (!done.load(std::memory_order_relaxed)) {
+    auto due = std::chrono::steady_clock::now() + kTick;
+    co_await rt.sleepUntil(due);
+    lateness.push_back(std::chrono::steady_clock::now() - due);
+  }
+}
+
+auto bench(char const* name, coco::MtOpt opt) -> void
+{
+  auto rt = coco::Runtime(coco::MT, kThreadCount, opt);
+  auto lateness = std::vector<std::chrono::nanoseconds>();
+  rt.block([](coco::Runtime& rt, std::vector<std::chrono::nanoseconds>& lateness) -> coco::Task<> {
+    auto done = std::atomic_bool(false);
+    auto tick = rt.spawn(ticker(rt, done, lateness));
+    for (int i = 0; i < kBursts; i++) {
+      auto latch = coco::sync::Latch(kBurst);
+      for (int j = 0; j < kBurst; j++) {
+        rt.spawnDetach(busyTask(latch));
+      }
+      co_await latch.wait();
+    }
+    done = true;
+    co_await tick.join();
+  }(rt, lateness));
+  std::sort(lateness.begin(), lateness.end());
+  auto stats = rt.stats().total();
+  ::printf("%-10s ticks %6zu  lateness p50 %9ld ns  p99 %9ld ns  max %9ld ns  budget polls %lu\n", name,
+           lateness.size(), lateness[lateness.size() / 2].count(), lateness[lateness.size() * 99 / 100].count(),
+           lateness.back().count(), stats.mBudgetPolls);
+}
+
+auto main() -> int
+{
+  bench("unbounded", coco::MtOpt{.mBudgetJobs = 0, .mBudgetTime = {}});
+  bench("budget", coco::MtOpt{});
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include <coco/runtime.hpp>
+#include <coco/sync.hpp>
+
+#include <cstdio>
+#include <random>
+
+// an overloaded worker handed a burst of requests with random client deadlines, spawned in arrival order without
+// deadlines, with deadlines, and with deadlines and shedding of the requests which can't make it any more.
+// Plain EDF is expected to do worst here: under sustained overload the earliest deadline is always one which is
+// already missed, which is what shedding is for.
+constexpr auto kThreadCount = 1;
+constexpr auto kRequests = 50'000;
+constexpr auto kWork = std::chrono::microseconds(2);
+constexpr auto kMaxDeadline = std::chrono::milliseconds(150);
+
+struct Outcome {
+  std::atomic_uint64_t mMet = 0;
+  std::atomic_uint64_t mMissed = 0;
+  std::atomic_uint64_t mShed = 0;
+};
+
+auto handle(coco::Instant deadline, Outcome& outcome) -> coco::Task<>
+{
+  auto start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start < kWork) {
+  }
+  auto& counter = std::chrono::steady_clock::now() <= deadline ? outcome.mMet : outcome.mMissed;
+  counter.fetch_add(1, std::memory_order_relaxed);
+  co_return;
+}
+
+enum class Mode { Fifo, Edf, EdfShed };
+
+auto bench(char const* name, Mode mode) -> void
+{
+  auto rt = coco::Runtime(coco::MT, kThreadCount);
+  auto outcome = Outcome();
+  auto rng = std::mt19937(42);
+  auto dist = std::uniform_int_distribution<std::int64_t>(0, kMaxDeadline.count());
+  auto const start = std::chrono::steady_clock::now();
+  rt.block([](coco::Runtime& rt, Mode mode, Outcome& outcome, std::mt19937& rng, auto& dist) -> coco::Task<> {
+    auto handles = std::vector<coco::JoinHandle<coco::Task<>>>();
+    handles.reserve(kRequests);
+    for (int i = 0; i < kRequests; i++) {
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(dist(rng));
+      if (mode == Mode::Fifo) {
+        handles.push_back(rt.spawn(handle(deadline, outcome)));
+      } else {
+        handles.push_back(rt.spawn(handle(deadline, outcome), {deadline, mode == Mode::EdfShed}));
+      }
+    }
+    for (auto& handle : handles) {
+      co_await handle.join();
+      try {
+        handle.result();
+      } catch (std::system_error const&) {
+        outcome.mShed.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }(rt, mode, outcome, rng, dist));
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+  ::printf("%-10s met %6lu  missed %6lu  shed %6lu  in %5ld ms\n", name, outcome.mMet.load(), outcome.mMissed.load(),
+           outcome.mShed.load(), std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+auto main() -> int
+{
+  bench("fifo", Mode::Fifo);
+  bench("edf", Mode::Edf);
+  bench("edf+shed", Mode::EdfShed);
+}
\ No newline at end of file
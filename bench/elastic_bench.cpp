@@ -0,0 +1,48 @@
+#include <coco/runtime.hpp>
+#include <coco/sync.hpp>
+
+#include <cstdio>
+#include <ranges>
+
+// load that comes and goes: bursts of cpu bound tasks separated by idle gaps. Prints the worker count the controller
+// settles on over time, and the elapsed time of each burst next to a fixed size executor.
+constexpr auto kMaxThreads = 8;
+constexpr auto kBursts = 4;
+constexpr auto kBurstTasks = 20'000;
+constexpr auto kIdleGap = std::chrono::milliseconds(300);
+
+auto burn(coco::sync::Latch& latch) -> coco::Task<>
+{
+  auto volatile x = 0u;
+  for (auto i = 0u; i < 20'000; i++) {
+    x = x + i;
+  }
+  latch.countDown();
+  co_return;
+}
+
+auto bench(char const* name, coco::MtOpt opt, std::size_t threads) -> void
+{
+  auto rt = coco::Runtime(coco::MT, threads, opt);
+  for (int burst = 0; burst < kBursts; burst++) {
+    auto const start = std::chrono::steady_clock::now();
+    rt.block([](coco::Runtime& rt) -> coco::Task<> {
+      auto latch = coco::sync::Latch(kBurstTasks);
+      rt.spawnMany(std::views::iota(0, kBurstTasks) | std::views::transform([&](int) { return burn(latch); }));
+      co_await latch.wait();
+    }(rt));
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    auto const busy = rt.workerCount();
+    std::this_thread::sleep_for(kIdleGap);
+    ::printf("%-8s burst %d  %6ld us  workers after burst %zu, after idle gap %zu\n", name, burst,
+             std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(), busy, rt.workerCount());
+  }
+  auto mt = static_cast<coco::MtExecutor*>(rt.executor());
+  ::printf("%-8s resizes %lu\n", name, mt->resizes());
+}
+
+auto main() -> int
+{
+  bench("fixed", {}, kMaxThreads);
+  bench("elastic", {.mMaxThreads = kMaxThreads, .mScaleInterval = std::chrono::milliseconds(2)}, 1);
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include <coco/runtime.hpp>
+#include <coco/sys/file.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// reads a file once with `File::read()` into a plain buffer and once into a registered buffer with READ_FIXED, for
+// blocks from 4 KiB to 1 MiB. The file is read from the page cache, so the difference is mostly the page pinning.
+constexpr std::size_t kFileSize = 64 << 20;
+constexpr std::size_t kMaxBlock = 1 << 20;
+constexpr int kRounds = 4;
+
+auto readPlain(coco::sys::File& file, std::size_t block, std::size_t& total) -> coco::Task<>
+{
+  auto buf = std::vector<std::byte>(block);
+  for (int round = 0; round < kRounds; round++) {
+    for (off_t offset = 0; offset < off_t(kFileSize); offset += block) {
+      auto [n, e] = co_await file.read(buf, offset);
+      if (e != std::errc(0) || n == 0) {
+        co_return;
+      }
+      total += n;
+    }
+  }
+}
+
+auto readFixed(coco::sys::File& file, std::size_t block, std::size_t& total) -> coco::Task<>
+{
+  auto buf = coco::FixedBuffer::lease();
+  for (int round = 0; round < kRounds; round++) {
+    for (off_t offset = 0; offset < off_t(kFileSize); offset += block) {
+      auto [n, e] = co_await file.read(buf, offset, block);
+      if (e != std::errc(0) || n == 0) {
+        co_return;
+      }
+      total += n;
+    }
+  }
+}
+
+template <typename Fn>
+auto bench(char const* name, coco::sys::File& file, std::size_t block, Fn fn) -> void
+{
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto total = std::size_t(0);
+  auto start = std::chrono::steady_clock::now();
+  rt.block(fn(file, block, total));
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  ::printf("%-6s %8zu KiB %10.1f MB/s\n", name, block >> 10, double(total) / double(us == 0 ? 1 : us));
+}
+
+auto main() -> int
+{
+  coco::BufferPool::configure(16, kMaxBlock);
+  char path[] = "/tmp/coco_fixed_bufferXXXXXX";
+  auto fd = ::mkstemp(path);
+  if (fd < 0) {
+    ::perror("mkstemp");
+    return 1;
+  }
+  ::unlink(path);
+  auto chunk = std::vector<char>(kMaxBlock, 'x');
+  for (std::size_t written = 0; written < kFileSize; written += chunk.size()) {
+    if (::write(fd, chunk.data(), chunk.size()) != ssize_t(chunk.size())) {
+      ::perror("write");
+      return 1;
+    }
+  }
+  auto file = coco::sys::File(fd);
+  for (std::size_t block = 4 << 10; block <= kMaxBlock; block *= 4) {
+    bench("plain", file, block, readPlain);
+    bench("fixed", file, block, readFixed);
+  }
+}
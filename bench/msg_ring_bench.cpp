@@ -0,0 +1,65 @@
+#include <coco/runtime.hpp>
+#include <coco/sync.hpp>
+#include <coco/sync/channel.hpp>
+
+#include <cstdio>
+
+// the spawn and channel examples, once with eventfd wakeups and once with IORING_OP_MSG_RING wakeups and job
+// hand-over. Both runs are the same on kernels without IORING_OP_MSG_RING.
+constexpr auto kThreadCount = 4;
+constexpr auto kSpawnCount = 1'000'000;
+constexpr auto kMessageCount = 1'000'000;
+
+auto tinyTask(coco::sync::Latch& latch) -> coco::Task<>
+{
+  latch.countDown();
+  co_return;
+}
+
+auto spawnMany(coco::Runtime& rt) -> coco::Task<>
+{
+  auto latch = coco::sync::Latch(kSpawnCount);
+  for (int i = 0; i < kSpawnCount; i++) {
+    rt.spawnDetach(tinyTask(latch));
+  }
+  co_await latch.wait();
+}
+
+auto pingPong(coco::Runtime& rt) -> coco::Task<>
+{
+  using ChanType = coco::sync::Channel<int, 64>;
+  auto chan = ChanType();
+  auto reader = rt.spawn([](ChanType& chan) -> coco::Task<> {
+    for (int i = 0; i < kMessageCount; i++) {
+      co_await chan.read();
+    }
+  }(chan));
+  auto writer = rt.spawn([](ChanType& chan) -> coco::Task<> {
+    for (int i = 0; i < kMessageCount; i++) {
+      co_await chan.write(i);
+    }
+  }(chan));
+  co_await reader.join();
+  chan.close();
+  co_await writer.join();
+}
+
+template <typename Fn>
+auto bench(char const* name, bool msgRing, Fn fn) -> void
+{
+  auto rt = coco::Runtime(coco::MT, kThreadCount, coco::MtOpt{.mMsgRing = msgRing});
+  auto start = std::chrono::steady_clock::now();
+  rt.block(fn(rt));
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  auto stats = rt.stats().total();
+  ::printf("%-8s %-8s %8ld ms %10lu wakeups %10lu hand-overs\n", name, msgRing ? "msg-ring" : "eventfd", ms,
+           stats.mUnparks, stats.mHandOvers);
+}
+
+auto main() -> int
+{
+  for (auto msgRing : {false, true}) {
+    bench("spawn", msgRing, spawnMany);
+    bench("channel", msgRing, pingPong);
+  }
+}
\ No newline at end of file
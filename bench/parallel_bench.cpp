@@ -0,0 +1,67 @@
+#include <coco/runtime.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <execution>
+#include <numeric>
+#include <random>
+
+// parallelFor / parallelReduce / parallelSort against the standard parallel algorithms with `std::execution::par`
+// and their sequential versions on the same data. Without a parallel backend, e.g. libstdc++ built without TBB,
+// `std::execution::par` silently runs sequentially.
+constexpr auto kThreadCount = 4;
+constexpr std::size_t kSize = 10'000'000;
+constexpr std::size_t kGrain = 16 * 1024;
+
+template <typename Fn>
+auto measure(char const* name, Fn fn) -> void
+{
+  auto const start = std::chrono::steady_clock::now();
+  fn();
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+  ::printf("  %-10s %8ld us\n", name, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+auto main() -> int
+{
+  auto rt = coco::Runtime(coco::MT, kThreadCount);
+  auto values = std::vector<double>(kSize);
+  std::iota(values.begin(), values.end(), 0.0);
+  auto const transform = [](double& v) { v = std::sqrt(v) * 1.5 + 1.0; };
+
+  ::printf("for_each over %zu doubles\n", kSize);
+  measure("seq", [&] { std::for_each(values.begin(), values.end(), transform); });
+  measure("std::par", [&] { std::for_each(std::execution::par, values.begin(), values.end(), transform); });
+  measure("coco", [&] {
+    rt.block([](coco::Runtime& rt, std::vector<double>& values, auto transform) -> coco::Task<> {
+      co_await rt.parallelFor(values, kGrain, transform);
+    }(rt, values, transform));
+  });
+
+  auto sum = 0.0;
+  ::printf("reduce over %zu doubles\n", kSize);
+  measure("seq", [&] { sum = std::reduce(values.begin(), values.end(), 0.0); });
+  measure("std::par", [&] { sum = std::reduce(std::execution::par, values.begin(), values.end(), 0.0); });
+  measure("coco", [&] {
+    rt.block([](coco::Runtime& rt, std::vector<double>& values, double& sum) -> coco::Task<> {
+      sum = co_await rt.parallelReduce(values, kGrain, 0.0, std::plus<>());
+    }(rt, values, sum));
+  });
+
+  auto rng = std::mt19937(42);
+  auto ints = std::vector<int>(kSize);
+  std::generate(ints.begin(), ints.end(), [&] { return int(rng()); });
+  ::printf("sort of %zu ints\n", kSize);
+  auto data = ints;
+  measure("seq", [&] { std::sort(data.begin(), data.end()); });
+  data = ints;
+  measure("std::par", [&] { std::sort(std::execution::par, data.begin(), data.end()); });
+  data = ints;
+  measure("coco", [&] {
+    rt.block([](coco::Runtime& rt, std::vector<int>& data) -> coco::Task<> {
+      co_await rt.parallelSort(data, kGrain * 8);
+    }(rt, data));
+  });
+  ::printf("sorted: %s\n", std::is_sorted(data.begin(), data.end()) ? "yes" : "no");
+}
\ No newline at end of file
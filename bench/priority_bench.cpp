@@ -0,0 +1,69 @@
+#include <coco/runtime.hpp>
+#include <coco/sync.hpp>
+
+#include <algorithm>
+#include <cstdio>
+
+// queueing delay of small interactive requests behind a flood of background work, once with every task in the same
+// class and once with the requests in `Priority::Interactive`. A single worker makes both share one set of queues.
+constexpr auto kThreadCount = 1;
+constexpr auto kFlood = 200'000;
+constexpr auto kTick = std::chrono::microseconds(100);
+
+auto busyTask(coco::sync::Latch& latch) -> coco::Task<>
+{
+  auto start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start < std::chrono::nanoseconds(500)) {
+  }
+  latch.countDown();
+  co_return;
+}
+
+auto request(std::chrono::steady_clock::time_point queued, std::vector<std::chrono::nanoseconds>& delays)
+    -> coco::Task<>
+{
+  delays.push_back(std::chrono::steady_clock::now() - queued);
+  co_return;
+}
+
+auto client(coco::Runtime& rt, coco::Priority prio, std::atomic_bool& done,
+            std::vector<std::chrono::nanoseconds>& delays) -> coco::Task<>
+{
+  while (!done.load(std::memory_order_relaxed)) {
+    co_await rt.sleepFor(kTick);
+    co_await rt.spawn(request(std::chrono::steady_clock::now(), delays).withPriority(prio)).join();
+  }
+}
+
+auto bench(char const* name, coco::Priority requestPrio) -> void
+{
+  auto rt = coco::Runtime(coco::MT, kThreadCount);
+  auto delays = std::vector<std::chrono::nanoseconds>();
+  rt.block([](coco::Runtime& rt, coco::Priority prio, std::vector<std::chrono::nanoseconds>& delays) -> coco::Task<> {
+    auto done = std::atomic_bool(false);
+    auto requests = rt.spawn(client(rt, prio, done, delays));
+    auto latch = coco::sync::Latch(kFlood);
+    for (int i = 0; i < kFlood; i++) {
+      rt.spawnDetach(busyTask(latch).withPriority(coco::Priority::Background));
+    }
+    co_await latch.wait();
+    done = true;
+    co_await requests.join();
+  }(rt, requestPrio, delays));
+  std::sort(delays.begin(), delays.end());
+  auto stats = rt.stats().total();
+  ::printf("%-12s requests %6zu  delay p50 %9ld ns  p99 %9ld ns  max %9ld ns\n", name, delays.size(),
+           delays[delays.size() / 2].count(), delays[delays.size() * 99 / 100].count(), delays.back().count());
+  for (std::size_t i = 0; i < coco::kPriorityCount; i++) {
+    if (stats.mClassRuns[i] > 0) {
+      ::printf("  class %zu: runs %8lu  avg wait %8lu us\n", i, stats.mClassRuns[i],
+               stats.mClassWaitUs[i] / stats.mClassRuns[i]);
+    }
+  }
+}
+
+auto main() -> int
+{
+  bench("one class", coco::Priority::Background);
+  bench("interactive", coco::Priority::Interactive);
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include <coco/runtime.hpp>
+#include <coco/sync.hpp>
+
+#include <cstdio>
+#include <ranges>
+
+// fan-out of trivial tasks spawned one `spawnDetach()` at a time and with one `spawnMany()`, until all of them ran
+constexpr auto kThreadCount = 4;
+constexpr int kFanOuts[] = {10'000, 100'000, 1'000'000};
+
+auto leaf(coco::sync::Latch& latch) -> coco::Task<>
+{
+  latch.countDown();
+  co_return;
+}
+
+auto bench(char const* name, int count, bool many) -> void
+{
+  auto rt = coco::Runtime(coco::MT, kThreadCount);
+  auto const start = std::chrono::steady_clock::now();
+  rt.block([](coco::Runtime& rt, int count, bool many) -> coco::Task<> {
+    auto latch = coco::sync::Latch(count);
+    if (many) {
+      rt.spawnMany(std::views::iota(0, count) | std::views::transform([&](int) { return leaf(latch); }));
+    } else {
+      for (int i = 0; i < count; i++) {
+        rt.spawnDetach(leaf(latch));
+      }
+    }
+    co_await latch.wait();
+  }(rt, count, many));
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+  auto stats = rt.stats().total();
+  ::printf("%-12s %8d tasks  %6ld us  %6.1f ns/task  wakeups %lu\n", name, count,
+           std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(),
+           double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / count, stats.mUnparks);
+}
+
+auto main() -> int
+{
+  for (auto count : kFanOuts) {
+    bench("spawnDetach", count, false);
+    bench("spawnMany", count, true);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include <coco/runtime.hpp>
+
+#include <algorithm>
+#include <cstdio>
+
+// short bursty requests: each round spawns a tiny task and joins it after a short pause, so workers keep going idle
+// right before the next request arrives. Compares parking immediately against spinning first.
+constexpr auto kThreadCount = 4;
+constexpr auto kRounds = 20'000;
+constexpr auto kPause = std::chrono::microseconds(20);
+
+auto tinyTask() -> coco::Task<> { co_return; }
+
+auto bench(char const* name, coco::MtOpt opt) -> void
+{
+  auto rt = coco::Runtime(coco::MT, kThreadCount, opt);
+  auto latencies = std::vector<std::chrono::nanoseconds>();
+  latencies.reserve(kRounds);
+  rt.block([](coco::Runtime& rt, std::vector<std::chrono::nanoseconds>& latencies) -> coco::Task<> {
+    for (int i = 0; i < kRounds; i++) {
+      auto start = std::chrono::steady_clock::now();
+      co_await rt.spawn(tinyTask()).join();
+      latencies.push_back(std::chrono::steady_clock::now() - start);
+      while (std::chrono::steady_clock::now() - start < kPause) {
+      }
+    }
+  }(rt, latencies));
+  std::sort(latencies.begin(), latencies.end());
+  auto stats = rt.stats().total();
+  ::printf("%-8s p50 %7ld ns  p99 %7ld ns  spin hits %8lu misses %8lu\n", name, latencies[kRounds / 2].count(),
+           latencies[kRounds * 99 / 100].count(), stats.mSpinHits, stats.mSpinMisses);
+}
+
+auto main() -> int
+{
+  bench("park", coco::MtOpt{.mSpinMax = 0});
+  bench("spin", coco::MtOpt{});
+}
\ No newline at end of file
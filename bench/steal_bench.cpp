@@ -0,0 +1,42 @@
+#include <coco/runtime.hpp>
+#include <coco/sync.hpp>
+
+#include <cstdio>
+
+// heavy_task.cpp with a skewed load: the balancer puts every kThreadCount-th task on the same worker and those
+// tasks are much heavier than the others, so without stealing one worker ends up with most of the work.
+constexpr auto kThreadCount = 4;
+constexpr auto kTaskCount = 1'000'000;
+constexpr auto kHeavyIter = 64;
+
+auto heavyTask(coco::sync::Latch& latch, int iter) -> coco::Task<>
+{
+  for (int i = 0; i < iter; i++) {
+    // do some calculation
+    std::this_thread::yield();
+  }
+  latch.countDown();
+  co_return;
+}
+
+auto bench(char const* name, coco::MtOpt opt) -> void
+{
+  auto rt = coco::Runtime(coco::MT, kThreadCount, opt);
+  auto start = std::chrono::steady_clock::now();
+  rt.block([](coco::Runtime& rt) -> coco::Task<> {
+    auto latch = coco::sync::Latch(kTaskCount);
+    for (int i = 0; i < kTaskCount; i++) {
+      rt.spawnDetach(heavyTask(latch, i % kThreadCount == 0 ? kHeavyIter : 1));
+    }
+    co_await latch.wait();
+    co_return;
+  }(rt));
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  ::printf("%-12s %8ld ms %12.0f tasks/s\n", name, ms, kTaskCount * 1000.0 / std::max<long>(ms, 1));
+}
+
+auto main() -> int
+{
+  bench("no-steal", coco::MtOpt{.mStealing = false});
+  bench("steal", coco::MtOpt{.mStealing = true});
+}
\ No newline at end of file
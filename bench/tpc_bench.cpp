@@ -0,0 +1,40 @@
+#include <coco/runtime.hpp>
+
+#include <cstdio>
+#include <vector>
+
+// per-connection style work: many independent tasks which each yield back and forth, like a proxy waiting on io.
+// The shared-queue executor balances and steals them, the thread-per-core one keeps every task on its core.
+constexpr auto kThreadCount = 4;
+constexpr auto kTasksPerCore = 256;
+constexpr auto kRounds = 2'000;
+
+auto session() -> coco::Task<>
+{
+  for (int i = 0; i < kRounds; i++) {
+    co_await coco::Yield();
+  }
+}
+
+auto bench(char const* name, coco::RuntimeKind kind) -> void
+{
+  auto rt = coco::Runtime(kind, kThreadCount);
+  auto const start = std::chrono::steady_clock::now();
+  rt.block([](coco::Runtime& rt) -> coco::Task<> {
+    auto handles = std::vector<coco::JoinHandle<coco::Task<>>>();
+    for (std::uint32_t i = 0; i < kThreadCount * kTasksPerCore; i++) {
+      handles.push_back(rt.spawnOn(i % kThreadCount, session()));
+    }
+    co_await rt.waitAll(std::span(handles));
+  }(rt));
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+  auto const switches = double(kThreadCount) * kTasksPerCore * kRounds;
+  ::printf("%-4s %8ld us  %6.1f ns/switch\n", name,
+           std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(), double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / switches);
+}
+
+auto main() -> int
+{
+  bench("MT", coco::MT);
+  bench("TPC", coco::TPC);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include <coco/runtime.hpp>
+#include <coco/sync.hpp>
+
+#include <cstdio>
+
+// spawns many tiny tasks, one at a time and in batches, and reports how many eventfd writes it took to wake the
+// workers for them.
+constexpr auto kThreadCount = 4;
+constexpr auto kTaskCount = 1'000'000;
+constexpr auto kBurst = 64;
+
+auto tinyTask(coco::sync::Latch& latch) -> coco::Task<>
+{
+  latch.countDown();
+  co_return;
+}
+
+auto bench(char const* name, bool burst) -> void
+{
+  auto rt = coco::Runtime(coco::MT, kThreadCount);
+  auto start = std::chrono::steady_clock::now();
+  rt.block([](coco::Runtime& rt, bool burst) -> coco::Task<> {
+    auto latch = coco::sync::Latch(kTaskCount);
+    for (int i = 0; i < kTaskCount; i++) {
+      rt.spawnDetach(tinyTask(latch));
+      if (burst && i % kBurst == kBurst - 1) {
+        co_await rt.sleepFor(std::chrono::microseconds(10));
+      }
+    }
+    co_await latch.wait();
+  }(rt, burst));
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  auto stats = rt.stats().total();
+  ::printf("%-8s %8ld ms %10lu wakeups %8.4f wakeups/task\n", name, ms, stats.mUnparks,
+           double(stats.mUnparks) / kTaskCount);
+}
+
+auto main() -> int
+{
+  bench("steady", false);
+  bench("bursty", true);
+}
\ No newline at end of file
@@ -1,8 +1,8 @@
 #include <coco/runtime.hpp>
 #include <coco/sync.hpp>
 #include <random>
+#include <ranges>
 
-// TODO: not efficient in this case
 static auto rt = coco::Runtime(coco::MT, 16);
 constexpr auto kTaskCount = 100'000'000;
 
@@ -24,9 +24,7 @@ auto main() -> int
 {
   rt.block([]() -> coco::Task<> {
     auto latch = coco::sync::Latch(kTaskCount);
-    for (int i = 0; i < kTaskCount; i++) {
-      rt.spawnDetach(heavy_task(latch));
-    }
+    rt.spawnMany(std::views::iota(0, kTaskCount) | std::views::transform([&](int) { return heavy_task(latch); }));
     co_await latch.wait();
     co_return;
   }());
@@ -0,0 +1,64 @@
+#include <coco/net.hpp>
+#include <coco/runtime.hpp>
+
+#include <string_view>
+#include <thread>
+using namespace std::literals;
+
+// the simple_server response, served thread-per-core: every core binds its own SO_REUSEPORT listener on the same
+// port and handles the connections the kernel gives it without touching another core
+auto print(std::string_view msg, std::errc errc) -> void
+{
+  ::printf("%s: %s\n", msg.data(), std::generic_category().message(static_cast<int>(errc)).c_str());
+}
+
+auto serve(coco::Runtime& rt, std::uint32_t core) -> coco::Task<>
+{
+  using namespace coco::sys;
+  auto addr = SocketAddr(SocketAddrV4::loopback(2333));
+  auto [listener, errc] = TcpListener::bindShard(addr);
+  if (errc != std::errc{0}) {
+    print("bind error", errc);
+    co_return;
+  }
+  ::printf("core %u listening\n", core);
+  while (true) {
+    auto [stream, errc0] = co_await listener.accept();
+    if (errc0 != std::errc{0}) {
+      print("accept error", errc0);
+      co_return;
+    }
+    // a detached spawn from a core stays on it, and so does the connection
+    rt.spawnDetach([](TcpStream stream) -> coco::Task<> {
+      std::array<char, 1024> buf{};
+      auto [n, errc1] = co_await stream.recv(std::as_writable_bytes(std::span(buf)));
+      if (errc1 != std::errc(0)) {
+        print("recv error", errc1);
+        co_return;
+      }
+      std::string str;
+      str.reserve(1024 + 128);
+      const auto http200 = "HTTP/1.1 200 OK\r\nContent-Length: 1024\r\nConnection: close\r\n\r\n"sv;
+      str.append(http200);
+      str.append(1024, 'a');
+      auto [n2, errc2] = co_await stream.send(std::as_bytes(std::span(str)));
+      if (errc2 != std::errc(0)) {
+        print("send error", errc2);
+      }
+      co_await stream.close();
+    }(std::move(stream)));
+  }
+}
+
+auto main() -> int
+{
+  auto const cores = std::max(std::thread::hardware_concurrency(), 1u);
+  static auto rt = coco::Runtime(coco::TPC, cores, {.mPlacement = coco::MtOpt::Placement::Spread});
+  rt.block([](std::uint32_t cores) -> coco::Task<> {
+    auto handles = std::vector<coco::JoinHandle<coco::Task<>>>();
+    for (std::uint32_t core = 0; core < cores; core++) {
+      handles.push_back(rt.spawnOn(core, serve(rt, core)));
+    }
+    co_await rt.waitAll(std::span(handles));
+  }(cores));
+}
\ No newline at end of file
@@ -29,8 +29,9 @@ auto main() -> int
     }
 
     static auto latch = coco::sync::Latch(10000000);
+    auto connections = listener.acceptStream();
     for (int i = 0; i < 10000000; i++) {
-      auto [stream, errc0] = co_await listener.accept();
+      auto [stream, errc0] = co_await connections.next();
 
       if (errc0 != std::errc{0}) {
         print("accept error", errc0);
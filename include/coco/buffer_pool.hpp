@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace coco {
+class IoUring;
+class BufferPool;
+
+struct BufferPoolStats {
+  std::size_t mBufferSize = 0;
+  std::uint32_t mCapacity = 0;
+  std::uint32_t mInUse = 0;
+  std::uint32_t mHighWater = 0; // most buffers leased at once
+  std::uint64_t mLeases = 0;
+  std::uint64_t mExhausted = 0; // leases which found the pool empty
+  bool mRegistered = false;     // false if the kernel refused the registration, io then goes the plain path
+};
+
+// A buffer leased from a `BufferPool`, it goes back to the pool when destroyed, on any thread. `size()` is the part
+// which holds data: reads set it, writes send it.
+class FixedBuffer {
+public:
+  FixedBuffer() noexcept = default;
+  FixedBuffer(FixedBuffer&& other) noexcept
+      : mPool(std::move(other.mPool)), mData(std::exchange(other.mData, nullptr)), mIndex(other.mIndex),
+        mSize(std::exchange(other.mSize, 0))
+  {
+  }
+  auto operator=(FixedBuffer&& other) noexcept -> FixedBuffer&
+  {
+    if (this != &other) {
+      release();
+      mPool = std::move(other.mPool);
+      mData = std::exchange(other.mData, nullptr);
+      mIndex = other.mIndex;
+      mSize = std::exchange(other.mSize, 0);
+    }
+    return *this;
+  }
+  ~FixedBuffer() noexcept { release(); }
+
+  // a buffer of the calling thread's pool, empty if all of them are leased
+  static auto lease() -> FixedBuffer;
+
+  explicit operator bool() const noexcept { return mData != nullptr; }
+  auto data() const noexcept -> std::byte* { return mData; }
+  auto capacity() const noexcept -> std::size_t;
+  auto size() const noexcept -> std::size_t { return mSize; }
+  auto resize(std::size_t size) noexcept -> void { mSize = std::min(size, capacity()); }
+  auto span() const noexcept -> std::span<std::byte> { return {mData, mSize}; }
+  auto whole() const noexcept -> std::span<std::byte> { return {mData, capacity()}; }
+  // index of the buffer in the ring's registration
+  auto index() const noexcept -> std::uint16_t { return std::uint16_t(mIndex); }
+  auto pool() const noexcept -> BufferPool const* { return mPool.get(); }
+
+  auto release() noexcept -> void;
+
+private:
+  friend class BufferPool;
+  FixedBuffer(std::shared_ptr<BufferPool> pool, std::byte* data, std::uint32_t index) noexcept
+      : mPool(std::move(pool)), mData(data), mIndex(index)
+  {
+  }
+
+  std::shared_ptr<BufferPool> mPool;
+  std::byte* mData = nullptr;
+  std::uint32_t mIndex = 0;
+  std::size_t mSize = 0;
+};
+
+// Buffers registered with one thread's io_uring by `io_uring_register_buffers`, so that READ_FIXED, WRITE_FIXED and
+// SEND_ZC use them without the kernel pinning the pages on every operation. Every `Proactor` sets up its own pool
+// on first use; a buffer used on another thread's ring goes the plain path there.
+class BufferPool : public std::enable_shared_from_this<BufferPool> {
+public:
+  constexpr static std::uint32_t kDefaultCount = 64;
+  constexpr static std::size_t kDefaultSize = 64 * 1024;
+  constexpr static std::uint32_t kMaxCount = 1 << 14; // limit of the kernel
+
+  // geometry of the pools which are set up from now on, e.g. before starting the runtime
+  static auto configure(std::uint32_t count, std::size_t size) noexcept -> void;
+  static auto create() -> std::shared_ptr<BufferPool>;
+
+  BufferPool(std::uint32_t count, std::size_t size);
+  BufferPool(BufferPool const&) = delete;
+  auto operator=(BufferPool const&) -> BufferPool& = delete;
+  ~BufferPool();
+
+  // MT-Safe, empty if all buffers are leased
+  auto lease() -> FixedBuffer;
+  // again after the ring was set up anew, the indices stay the same
+  auto registerWith(IoUring& ring) -> std::errc;
+  auto registered() const noexcept -> bool { return mRegistered; }
+  auto bufferSize() const noexcept -> std::size_t { return mBufferSize; }
+  auto stats() -> BufferPoolStats;
+
+private:
+  friend class FixedBuffer;
+  auto giveBack(std::uint32_t index) noexcept -> void;
+
+  std::byte* mMemory;
+  std::size_t mBufferSize;
+  std::uint32_t mCount;
+  bool mRegistered = false;
+
+  std::mutex mMt;
+  std::vector<std::uint32_t> mFree;
+  std::uint32_t mHighWater = 0;
+  std::uint64_t mLeases = 0;
+  std::uint64_t mExhausted = 0;
+};
+
+inline auto FixedBuffer::capacity() const noexcept -> std::size_t
+{
+  return mPool != nullptr ? mPool->bufferSize() : 0;
+}
+inline auto FixedBuffer::release() noexcept -> void
+{
+  if (mData != nullptr) {
+    mPool->giveBack(mIndex);
+    mData = nullptr;
+    mSize = 0;
+    mPool.reset();
+  }
+}
+} // namespace coco
\ No newline at end of file
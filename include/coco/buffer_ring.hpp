@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+struct io_uring_buf_ring;
+
+namespace coco {
+class IoUring;
+class BufferRing;
+
+struct BufferRingStats {
+  std::size_t mBufferSize = 0;
+  std::uint32_t mCapacity = 0;
+  std::uint32_t mInUse = 0;     // handed to the application, the rest waits in the kernel's ring
+  std::uint32_t mHighWater = 0; // most buffers in use at once
+  std::uint64_t mSelected = 0;  // buffers the kernel picked for a recv
+  bool mRegistered = false;     // false if the kernel has no provided buffer rings, recvs then lease up front
+};
+
+// A buffer which the kernel filled from a `BufferRing`, it goes back to the ring when destroyed, on any thread.
+class ProvidedBuffer {
+public:
+  ProvidedBuffer() noexcept = default;
+  ProvidedBuffer(ProvidedBuffer&& other) noexcept
+      : mRing(std::move(other.mRing)), mData(std::exchange(other.mData, nullptr)), mId(other.mId),
+        mSize(std::exchange(other.mSize, 0))
+  {
+  }
+  auto operator=(ProvidedBuffer&& other) noexcept -> ProvidedBuffer&
+  {
+    if (this != &other) {
+      release();
+      mRing = std::move(other.mRing);
+      mData = std::exchange(other.mData, nullptr);
+      mId = other.mId;
+      mSize = std::exchange(other.mSize, 0);
+    }
+    return *this;
+  }
+  ~ProvidedBuffer() noexcept { release(); }
+
+  explicit operator bool() const noexcept { return mData != nullptr; }
+  auto data() const noexcept -> std::byte* { return mData; }
+  auto size() const noexcept -> std::size_t { return mSize; }
+  auto span() const noexcept -> std::span<std::byte> { return {mData, mSize}; }
+  // id of the buffer in its group
+  auto id() const noexcept -> std::uint16_t { return mId; }
+
+  auto release() noexcept -> void;
+
+private:
+  friend class BufferRing;
+  ProvidedBuffer(std::shared_ptr<BufferRing> ring, std::byte* data, std::uint16_t id, std::size_t size) noexcept
+      : mRing(std::move(ring)), mData(data), mId(id), mSize(size)
+  {
+  }
+
+  std::shared_ptr<BufferRing> mRing;
+  std::byte* mData = nullptr;
+  std::uint16_t mId = 0;
+  std::size_t mSize = 0;
+};
+
+// Buffers provided to one thread's io_uring as a buffer group with a buffer ring. A recv with IOSQE_BUFFER_SELECT
+// takes a buffer only once data arrived, so idle connections hold none. Every `Proactor` sets up its own ring on first
+// use, a released buffer goes straight back into the ring it came from.
+class BufferRing : public std::enable_shared_from_this<BufferRing> {
+public:
+  constexpr static std::uint32_t kDefaultCount = 256;
+  constexpr static std::size_t kDefaultSize = 16 * 1024;
+  constexpr static std::uint32_t kMaxCount = 1 << 15; // limit of the kernel
+  constexpr static std::uint16_t kGroupId = 0;        // one group per ring
+
+  // geometry of the rings which are set up from now on, `count` is rounded up to a power of two
+  static auto configure(std::uint32_t count, std::size_t size) noexcept -> void;
+  static auto create() -> std::shared_ptr<BufferRing>;
+
+  BufferRing(std::uint32_t count, std::size_t size);
+  BufferRing(BufferRing const&) = delete;
+  auto operator=(BufferRing const&) -> BufferRing& = delete;
+  ~BufferRing();
+
+  // hands every buffer which isn't in use to the kernel, again after the ring was set up anew
+  auto registerWith(IoUring& ring) -> std::errc;
+  // the kernel dropped the group with its ring, buffers stay with the application until `registerWith()`
+  auto detach() noexcept -> void;
+  auto registered() const noexcept -> bool { return mRegistered; }
+  auto groupId() const noexcept -> std::uint16_t { return kGroupId; }
+  auto bufferSize() const noexcept -> std::size_t { return mBufferSize; }
+
+  // the buffer a cqe with IORING_CQE_F_BUFFER in `cqeFlags` names, holding `len` bytes. Empty without the flag.
+  auto take(std::uint32_t cqeFlags, std::size_t len) -> ProvidedBuffer;
+  // MT-Safe, a buffer for a plain recv while the ring isn't registered, empty if all are in use
+  auto lease() -> ProvidedBuffer;
+  // `buf`, leased with `lease()`, now holds `len` bytes
+  auto fill(ProvidedBuffer& buf, std::size_t len) const noexcept -> void { buf.mSize = std::min(len, mBufferSize); }
+  auto stats() -> BufferRingStats;
+
+private:
+  friend class ProvidedBuffer;
+  auto giveBack(std::uint16_t id) noexcept -> void;
+  auto provide(std::uint16_t id, int offset) noexcept -> void;
+  auto markUsed(std::uint16_t id) noexcept -> void;
+
+  std::byte* mMemory;
+  ::io_uring_buf_ring* mRing;
+  std::size_t mBufferSize;
+  std::uint32_t mCount;
+  bool mRegistered = false;
+
+  std::mutex mMt;
+  std::vector<bool> mUsed;
+  std::vector<std::uint16_t> mFree; // buffers neither used nor in the kernel's ring, only while not registered
+  std::uint32_t mInUse = 0;
+  std::uint32_t mHighWater = 0;
+  std::uint64_t mSelected = 0;
+};
+
+inline auto ProvidedBuffer::release() noexcept -> void
+{
+  if (mData != nullptr) {
+    mRing->giveBack(mId);
+    mData = nullptr;
+    mSize = 0;
+    mRing.reset();
+  }
+}
+} // namespace coco
\ No newline at end of file
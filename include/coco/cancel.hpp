@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+namespace coco {
+namespace detail {
+// an operation in flight which a stop cancels, linked into the `StopState` while it is registered
+struct StopNode {
+  using CancelFn = void (*)(StopNode* node) noexcept;
+  CancelFn mCancel = nullptr;
+  StopNode* mPrev = nullptr;
+  StopNode* mNext = nullptr;
+  bool mCanceled = false; // `mCancel` ran, guarded by the state's lock
+};
+
+class StopState {
+public:
+  StopState() noexcept = default;
+  StopState(StopState const&) = delete;
+  auto operator=(StopState const&) -> StopState& = delete;
+
+  auto stopRequested() const noexcept -> bool { return mStopped.load(std::memory_order_acquire); }
+
+  // links `node`, returns false without linking it if the stop was already requested
+  auto attach(StopNode* node) noexcept -> bool
+  {
+    std::lock_guard lock(mMt);
+    if (mStopped.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    node->mCanceled = false;
+    node->mPrev = nullptr;
+    node->mNext = mHead;
+    if (mHead != nullptr) {
+      mHead->mPrev = node;
+    }
+    mHead = node;
+    return true;
+  }
+  // unlinks `node`, returns whether it was canceled before
+  auto detach(StopNode* node) noexcept -> bool
+  {
+    std::lock_guard lock(mMt);
+    if (node->mCanceled) {
+      return true;
+    }
+    if (node->mPrev != nullptr) {
+      node->mPrev->mNext = node->mNext;
+    } else {
+      mHead = node->mNext;
+    }
+    if (node->mNext != nullptr) {
+      node->mNext->mPrev = node->mPrev;
+    }
+    return false;
+  }
+  // cancels every linked node, returns false if the stop was already requested
+  auto requestStop() noexcept -> bool
+  {
+    std::lock_guard lock(mMt);
+    if (mStopped.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    mStopped.store(true, std::memory_order_release);
+    for (auto node = mHead; node != nullptr; node = node->mNext) {
+      node->mCanceled = true;
+      node->mCancel(node);
+    }
+    mHead = nullptr;
+    return true;
+  }
+
+private:
+  std::mutex mMt;
+  StopNode* mHead = nullptr;
+  std::atomic_bool mStopped{false};
+};
+} // namespace detail
+
+// A cheap handle to a `StopSource` which is passed to cancellable operations, e.g. `Socket::recv(buf, token)` or
+// `Runtime::sleepFor(duration, token)`. A default constructed token is never stopped.
+class CancellationToken {
+public:
+  CancellationToken() noexcept = default;
+  explicit CancellationToken(detail::StopState* state) noexcept : mState(state) {}
+
+  auto stopPossible() const noexcept -> bool { return mState != nullptr; }
+  auto stopRequested() const noexcept -> bool { return mState != nullptr && mState->stopRequested(); }
+
+  // registers an operation which is about to start, false if it must not start because the stop was requested
+  auto attach(detail::StopNode* node) const noexcept -> bool { return mState == nullptr || mState->attach(node); }
+  // unregisters an operation which completed, returns whether its cancel function ran
+  auto detach(detail::StopNode* node) const noexcept -> bool { return mState != nullptr && mState->detach(node); }
+
+private:
+  detail::StopState* mState = nullptr;
+};
+
+// Owner of a stop request. `requestStop()` cancels every operation which is in flight with one of its tokens: the io
+// is cancelled with IORING_OP_ASYNC_CANCEL on the ring which submitted it and the awaiter resumes with
+// `std::errc::operation_canceled`, operations started after the stop don't reach the kernel at all.
+// The source must outlive the operations which use its tokens.
+class StopSource {
+public:
+  StopSource() noexcept = default;
+  StopSource(StopSource const&) = delete;
+  auto operator=(StopSource const&) -> StopSource& = delete;
+
+  auto token() noexcept -> CancellationToken { return CancellationToken(&mState); }
+  // MT-Safe, returns false if the stop was already requested
+  auto requestStop() noexcept -> bool { return mState.requestStop(); }
+  auto stopRequested() const noexcept -> bool { return mState.stopRequested(); }
+
+private:
+  detail::StopState mState;
+};
+} // namespace coco
\ No newline at end of file
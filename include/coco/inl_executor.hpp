@@ -14,6 +14,8 @@ public:
 
   auto execute(WorkerJobQueue&& queue, std::size_t count, ExeOpt opt) noexcept -> void override;
   auto execute(WorkerJob* handle, ExeOpt opt) noexcept -> void override;
+  auto concurrency() const noexcept -> std::size_t override { return 1; }
+  auto executeBatches(std::span<WorkerJobQueue> batches, ExeOpt opt) noexcept -> void override;
   auto runMain(Task<> task) -> void override;
 
   auto forceStop() -> void;
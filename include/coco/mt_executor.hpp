@@ -1,74 +1,192 @@
 #pragma once
 
 #include "coco/proactor.hpp"
+#include "coco/stats.hpp"
+#include "coco/sys/topology.hpp"
 #include "coco/task.hpp"
+#include "coco/util/lockfree_queue.hpp"
+#include "coco/util/ws_deque.hpp"
+#include <array>
+#include <condition_variable>
 #include <latch>
+#include <mutex>
+#include <string>
 #include <thread>
 
 using namespace std::chrono_literals;
 
 namespace coco {
+class MtExecutor;
+
+struct MtOpt {
+  // idle workers steal half of a busy worker's local queue before parking
+  bool mStealing = true;
+  // `ExeOpt::PreferInOne` wakeups from a worker run right after the current job
+  bool mLifoSlot = true;
+  // upper bound of polling rounds an idle worker spends on its queues and cq ring before parking, 0 disables
+  // spinning. The actual budget adapts to how quickly recent parks were woken up.
+  std::uint32_t mSpinMax = 4096;
+  // jobs a worker runs, or time it spends running them, before it polls io completions and timers again. 0 means
+  // no limit. `Checkpoint` yields once this is used up.
+  std::uint32_t mBudgetJobs = 128;
+  std::chrono::microseconds mBudgetTime{500};
+  // workers wake each other, and hand jobs to parked peers, with IORING_OP_MSG_RING instead of the eventfd when the
+  // kernel supports it
+  bool mMsgRing = true;
+  // relative share of run slots each `Priority` class gets while several of them have jobs queued, indexed by the
+  // class. A class with jobs is never skipped for good, it just runs less often.
+  std::array<std::uint32_t, kPriorityCount> mPriorityWeights{16, 8, 4, 1};
+
+  enum class Placement {
+    None,   // leave workers to the kernel scheduler
+    Spread, // round-robin workers over numa nodes, one cpu each
+    Pack,   // fill the cpus of one node before moving to the next
+  };
+  Placement mPlacement = Placement::None;
+  // worker N is pinned to `mCpuSets[N % mCpuSets.size()]`, takes precedence over `mPlacement`
+  std::vector<std::vector<int>> mCpuSets{};
+  // build each worker with its queues, proactor and timers on its own thread after pinning, so that first-touch
+  // allocation places them on the worker's node
+  bool mNodeLocal = true;
+
+  // the worker count can change at runtime between `mMinThreads` and `mMaxThreads`, 0 keeps it fixed at the count
+  // given to the executor. Workers beyond the initial ones are started on first use and aren't node local.
+  std::uint32_t mMaxThreads = 0;
+  std::uint32_t mMinThreads = 1;
+  // period of the controller which grows the worker count while jobs queue up and no worker is idle, and shrinks it
+  // while most workers are parked. 0 leaves resizing to `MtExecutor::setWorkerCount()`.
+  std::chrono::milliseconds mScaleInterval{0};
+};
+
+struct WorkerPlacement {
+  std::uint32_t mTid = 0;
+  int mNode = -1; // index into `sys::CpuTopology::mNodes`, -1 if unpinned
+  std::vector<int> mCpus{};
+  bool mPinned = false;
+};
+// where worker `tid` runs under `opt.mCpuSets` or `opt.mPlacement`
+auto planPlacement(MtOpt const& opt, sys::CpuTopology const& topology, std::uint32_t tid) -> WorkerPlacement;
+
 class Worker {
 public:
   Worker() noexcept = default;
+  ~Worker() noexcept;
   Worker(Worker const&) = delete;
   Worker(Worker&&) = delete;
   auto operator=(Worker const&) -> Worker& = delete;
   auto operator=(Worker&&) -> Worker& = delete;
 
+  // leaves `task` untouched if the worker is stopped or dormant, so that the caller can pass it on
   template <typename T>
-  [[nodiscard]] auto enqueue(T task, ExeOpt opt) noexcept -> bool
+  [[nodiscard]] auto enqueue(T&& task, ExeOpt opt) noexcept -> bool
   {
     auto state = mState.load(std::memory_order_relaxed);
-    if (state == State::Stop) [[unlikely]] {
+    if (state == State::Stop || state == State::Dormant) [[unlikely]] {
       return false;
     } else {
-      pushTask(std::move(task), opt);
+      pushTask(std::forward<T>(task), opt);
       return true;
     }
   }
 
-  template <typename T>
-  [[nodiscard]] auto tryEnqeue(T task, ExeOpt opt) noexcept -> bool
-  {
-    auto state = mState.load(std::memory_order_relaxed);
-    if (state == State::Stop) [[unlikely]] {
-      return false;
-    } else {
-      return tryPushTask(std::move(task), opt);
-    }
-  }
-
   auto forceStop() -> void;
-  auto start(std::latch& latch) -> void;
+  auto start(std::latch& latch, MtExecutor* executor, std::uint32_t tid) -> void;
   auto loop() -> void;
   auto notify() -> void;
+  // blocked in the kernel, or about to, and not notified yet
+  auto parked() const noexcept -> bool { return mProactor->parked(); }
 
 private:
+  friend class MtExecutor;
+
   auto processTasks() -> void;
+  auto run(WorkerJob* job) -> void;
+  auto runLifoSlot() -> void;
+  auto refillBudget() -> void;
+  auto consumeBudget() -> void;
+  auto pushClass(WorkerJob* job) -> void;
+  auto pushDeadline(WorkerJob* job) -> void;
+  auto pickClass() noexcept -> std::size_t;
+  auto popClass(std::size_t c) -> WorkerJob*;
+  auto popWeighted() -> WorkerJob*;
+  auto queuedJobs() const noexcept -> std::size_t;
+  // jobs waiting for this worker, readable from other threads
+  auto backlog() const noexcept -> std::size_t;
+  auto trySteal() -> bool;
+  auto spin() -> bool;
+  auto hasWork() const noexcept -> bool;
+  auto park() -> void;
+  auto canPushLocal(ExeOpt opt) const noexcept -> bool;
+  auto retire() -> bool;
+  auto dormant() -> bool;
+  auto forwardJobs() -> void;
+  auto migrateTimers() -> void;
+  auto wakeDormant() noexcept -> void;
 
   auto pushTask(WorkerJob* job, ExeOpt opt) -> void;
-  auto tryPushTask(WorkerJob* job, ExeOpt opt) -> bool;
-
   auto pushTask(WorkerJobQueue jobs, ExeOpt opt) -> void;
-  auto tryPushTask(WorkerJobQueue jobs, ExeOpt opt) -> bool;
+
+  auto pushBack(WorkerJob* job) -> void;
+  auto pushLocal(WorkerJob* job) -> void;
+  auto pushInbox(WorkerJob* job, ExeOpt opt) -> void;
+  auto tryHandOver(WorkerJob* job, ExeOpt opt) -> bool;
+  auto pushInbox(WorkerJobQueue jobs, ExeOpt opt) -> void;
 
 private:
   enum class State {
     Waiting,
     Executing,
     Stop,
+    Dormant, // not started yet, or retired with its ring released until the worker count grows again
   };
+  constexpr static std::uint32_t kLocalQueueSize = 256;
+  // max jobs run back to back from the lifo slot before it is flushed to the queue
+  constexpr static std::uint32_t kLifoSlotCap = 3;
+  // pass increment of a class with weight 1 in the stride scheduler over the class queues
+  constexpr static std::uint64_t kStrideOne = 1 << 20;
+  // the clock and the cq ring are checked once every this many spin rounds
+  constexpr static std::uint32_t kSpinPollInterval = 32;
+  // a park woken up faster than this would have been better spent spinning
+  constexpr static auto kShortPark = std::chrono::microseconds(50);
 
   coco::Proactor* mProactor = nullptr;
-  std::mutex mQueueMt;
-  util::Queue<&WorkerJob::next> mTaskQueue;
-  std::atomic<State> mState;
+  MtExecutor* mExecutor = nullptr;
+  std::uint32_t mTid = 0;
+  // remote submissions, drained by the owner in one exchange per round
+  util::MpscQueue<&WorkerJob::next> mInbox;
+  util::MpscQueue<&WorkerJob::next> mHighInbox;
+  // jobs which must not leave this worker, e.g. `ExeOpt::ForceInOne`
+  util::MpscQueue<&WorkerJob::next> mPinnedInbox;
+  // one stealable queue per `Priority` class
+  std::array<util::WsDeque<WorkerJob, kLocalQueueSize>, kPriorityCount> mLocalQueues;
+  // remote jobs which didn't fit their class queue, moved in as it drains
+  std::array<WorkerJobQueue, kPriorityCount> mOverflow;
+  std::array<std::atomic_uint64_t, kPriorityCount> mOverflowCount{};
+  // jobs with a deadline, a min heap per class which is served before the class queue. Never stolen.
+  std::array<std::vector<WorkerJob*>, kPriorityCount> mDeadlines;
+  std::array<std::atomic_uint64_t, kPriorityCount> mDeadlineCount{};
+  std::array<std::uint64_t, kPriorityCount> mStride{};
+  std::array<std::uint64_t, kPriorityCount> mPass{};
+  std::uint64_t mVirtualTime = 0;
+  // clock read once per budget window, in executor microseconds it is stamped on the jobs queued meanwhile
+  Instant mNow{};
+  std::uint32_t mStamp = 0;
+  WorkerJob* mLifoSlot = nullptr;
+  std::uint32_t mSpinMax = 0;
+  std::uint32_t mSpinBudget = 0;
+  detail::WorkerCounters mStats;
+  std::atomic<State> mState = State::Dormant;
+  // set by `MtExecutor::setWorkerCount()`, the worker hands off its jobs and timers, waits for its io and goes dormant
+  std::atomic_bool mRetiring = false;
+  // a dormant worker sleeps on this futex word instead of its ring
+  std::atomic_uint32_t mDormantSeq = 0;
+  // other workers posting to this worker's ring with IORING_OP_MSG_RING right now, the ring stays open until it is 0
+  std::atomic_uint32_t mRingUsers = 0;
 };
 
 class MtExecutor : public Executor {
 public:
-  MtExecutor(std::size_t threadCount);
+  MtExecutor(std::size_t threadCount, MtOpt opt = {});
   ~MtExecutor() noexcept override
   {
     requestStop();
@@ -78,30 +196,84 @@ public:
   auto join() noexcept -> void;
   auto execute(WorkerJob* job, ExeOpt opt) noexcept -> void override;
   auto execute(WorkerJobQueue&& queue, std::size_t count, ExeOpt opt) noexcept -> void override;
+  auto concurrency() const noexcept -> std::size_t override { return mActiveCount.load(std::memory_order_relaxed); }
+  auto executeBatches(std::span<WorkerJobQueue> batches, ExeOpt opt) noexcept -> void override;
   auto runMain(Task<> task) -> void override;
 
+  // grows or shrinks the active workers to `count`, clamped to [`MtOpt::mMinThreads`, capacity()], and returns the
+  // new count. Retired workers finish their io before they go dormant, their queued jobs and timers move right away.
+  auto setWorkerCount(std::size_t count) -> std::size_t;
+  auto workerCount() const noexcept -> std::size_t { return mActiveCount.load(std::memory_order_relaxed); }
+  auto capacity() const noexcept -> std::size_t { return mThreadCount; }
+  // worker count changes made by setWorkerCount() and the controller
+  auto resizes() const noexcept -> std::uint64_t { return mResizes.load(std::memory_order_relaxed); }
+
+  auto option() const noexcept -> MtOpt const& { return mOpt; }
+  auto topology() const noexcept -> sys::CpuTopology const& { return mTopology; }
+  auto placement() const noexcept -> std::span<WorkerPlacement const> { return mPlacement; }
+  // human readable summary of the numa nodes and where each worker runs
+  auto topologyReport() const -> std::string;
+  // jobs waiting in the workers' class queues right now, per `Priority` class. Their runs and queueing time are in
+  // `stats()`.
+  auto queuedByClass() const noexcept -> std::array<std::uint64_t, kPriorityCount>;
+  // per worker scheduler counters, all zero unless built with COCO_STATS
+  auto stats() const -> RuntimeStats;
+
 private:
+  friend class Worker;
+
   template <typename T>
   auto balanceEnqueue(T task, ExeOpt opt) noexcept -> void
     requires std::is_same_v<WorkerJobQueue, T> || std::is_base_of_v<WorkerJob, std::remove_pointer_t<T>>
   {
     auto nextIdx = opt.mOpt == ExeOpt::Balance ? mNextWorker.fetch_add(1, std::memory_order_relaxed)
                                                : mNextWorker.load(std::memory_order_relaxed);
-    auto startIdx = nextIdx % mThreadCount;
+    // start at an active worker, the inactive ones only take jobs while they retire
+    auto startIdx = nextIdx % mActiveCount.load(std::memory_order_relaxed);
     for (std::uint32_t i = 0; i < mThreadCount; i++) {
       auto const idx = (startIdx + i) < mThreadCount ? (startIdx + i) : (startIdx + i - mThreadCount);
-      if (mWorkers[idx]->tryEnqeue(std::move(task), opt)) {
+      if (mWorkers[idx]->enqueue(std::move(task), opt)) {
         return;
       }
     }
-    auto r = mWorkers[startIdx]->enqueue(std::move(task), opt);
-    assert(r);
+    assert(false && "all workers are stopped");
   }
 
-  std::uint32_t const mThreadCount;
+  // wake one parked worker so it can steal from a busy one
+  auto wakeIdle() noexcept -> void;
+  auto startWorker(std::uint32_t tid, std::latch& started) -> void;
+  auto activate(std::uint32_t tid) -> void;
+  auto scaleLoop() -> void;
+
+  // grow the worker count once the backlog stays above this many jobs per worker with no worker parked
+  constexpr static std::size_t kScaleUpBacklog = 32;
+  constexpr static std::uint32_t kScaleUpRounds = 2;
+  // shrink it once more than half of the workers stayed parked for this many rounds
+  constexpr static std::uint32_t kScaleDownRounds = 10;
+
+  MtOpt const mOpt;
+  std::uint32_t const mThreadCount; // worker slots, workers [0, mActiveCount) are active
+  std::atomic_uint32_t mActiveCount;
+  std::atomic_uint64_t mResizes = 0;
+  // serializes resizing with retiring workers handing off their timers and going dormant
+  std::mutex mScaleMt;
+  std::thread mScaler;
+  std::mutex mScalerMt;
+  std::condition_variable mScalerCv;
+  bool mScalerStop = false;
   std::atomic_uint32_t mNextWorker = 0;
+  std::atomic_uint32_t mIdleCount = 0;
   std::vector<std::thread> mThreads;
   std::vector<std::unique_ptr<Worker>> mWorkers;
+  sys::CpuTopology mTopology;
+  std::vector<WorkerPlacement> mPlacement;
+  enum class Phase : std::uint8_t {
+    Building, // workers may look at each other only once all of them are built
+    Running,
+    Stopped, // requestStop() is done notifying, workers may release their thread local state
+  };
+  std::atomic<Phase> mPhase = Phase::Building;
+  std::chrono::steady_clock::time_point const mEpoch = std::chrono::steady_clock::now();
   std::atomic_uint32_t mSyncNextWorker = 0;
 };
 } // namespace coco
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "coco/task.hpp"
+
+#include <exception>
+
+namespace coco::detail {
+// Runs `body(chunk)` for every chunk in [0, chunkCount). The range is split in halves, the upper ones are queued on
+// the current worker where idle workers can steal them and the lower ones are split further in place, so the work
+// spreads out in O(log n) steps. Awaiting it suspends the caller until the last chunk is done. The first exception
+// thrown by `body` is rethrown to the awaiting coroutine, chunks which didn't start yet are skipped.
+template <typename Body>
+class ForkJoin {
+public:
+  ForkJoin(std::size_t chunkCount, Body& body) noexcept : mBody(body), mPending(chunkCount) {}
+  ForkJoin(ForkJoin const&) = delete;
+  auto operator=(ForkJoin const&) -> ForkJoin& = delete;
+
+  auto split(std::size_t begin, std::size_t end) noexcept -> void
+  {
+    while (end - begin > 1) {
+      auto const mid = begin + (end - begin) / 2;
+      auto task = fork(mid, end);
+      task.promise().setDetach();
+      Proactor::get().execute(task.promise().getThisJob(), ExeOpt::yield());
+      [[maybe_unused]] auto handle = task.take();
+      end = mid;
+    }
+    runChunk(begin);
+  }
+
+  // never ready by `mPending`: the state lives in the awaiting frame, and the last chunk still touches `mWaiter` after
+  // the count hit zero. Only the handshake on `mWaiter` tells that it is done with it.
+  auto await_ready() const noexcept -> bool { return false; }
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
+  {
+    WorkerJob* expected = nullptr;
+    return mWaiter.compare_exchange_strong(expected, handle.promise().getThisJob(), std::memory_order_acq_rel);
+  }
+  auto await_resume() const -> void
+  {
+    if (mError != nullptr) [[unlikely]] {
+      std::rethrow_exception(mError);
+    }
+  }
+
+private:
+  auto fork(std::size_t begin, std::size_t end) -> Task<>
+  {
+    split(begin, end);
+    co_return;
+  }
+  auto runChunk(std::size_t chunk) noexcept -> void
+  {
+    if (!mFailed.load(std::memory_order_relaxed)) {
+      try {
+        mBody(chunk);
+      } catch (...) {
+        if (!mFailed.exchange(true, std::memory_order_relaxed)) {
+          mError = std::current_exception();
+        }
+      }
+    }
+    if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      // the awaiting coroutine may not have suspended yet, then it sees `kEmptyJob` and doesn't
+      auto waiter = mWaiter.exchange(&kEmptyJob, std::memory_order_acq_rel);
+      if (waiter != nullptr) {
+        Proactor::get().execute(waiter, ExeOpt::prefInOne());
+      }
+    }
+  }
+
+  Body& mBody;
+  std::atomic_size_t mPending;
+  std::atomic<WorkerJob*> mWaiter{nullptr};
+  std::atomic_bool mFailed{false};
+  std::exception_ptr mError;
+};
+
+template <typename Body>
+auto forkJoin(std::size_t chunkCount, Body body) -> Task<>
+{
+  if (chunkCount == 0) {
+    co_return;
+  }
+  auto state = ForkJoin<Body>(chunkCount, body);
+  state.split(0, chunkCount); // the caller takes the first chunk itself
+  co_await state;
+}
+} // namespace coco::detail
\ No newline at end of file
@@ -1,19 +1,27 @@
 #pragma once
 
+#include "coco/buffer_pool.hpp"
+#include "coco/buffer_ring.hpp"
 #include "coco/timer.hpp"
 #include "coco/uring.hpp"
 #include "coco/util/fixed_vec.hpp"
 #include "coco/worker_job.hpp"
 
+#include <limits>
+
 namespace coco {
 struct CancelItem {
-  enum class Kind { IoFd, TimeoutToken } mKind;
+  enum class Kind { IoFd, TimeoutToken, IoToken, Timer } mKind;
   union {
     int mFd;
     Token mToken;
   };
   static auto cancelIo(int fd) -> CancelItem { return {Kind::IoFd, fd}; }
   static auto cancelTimeout(Token token) -> CancelItem { return {.mKind = Kind::TimeoutToken, .mToken = token}; }
+  // the operation submitted with `token`, it completes with -ECANCELED
+  static auto cancelJob(Token token) -> CancelItem { return {.mKind = Kind::IoToken, .mToken = token}; }
+  // the timer of `job` added with `Proactor::addTimer()`, the job runs right away unless the timer expired already
+  static auto cancelTimer(WorkerJob* job) -> CancelItem { return {.mKind = Kind::Timer, .mToken = job}; }
 };
 class Proactor {
 public:
@@ -34,44 +42,231 @@ public:
   auto getExecutor() const noexcept -> Executor* { return mExecutor; }
   auto execute(WorkerJobQueue&& queue, ExeOpt opt) noexcept -> void
   {
-    if (opt.mOpt == ExeOpt::PreferInOne) [[unlikely]] {
+    if (opt.inCurrent()) [[unlikely]] {
       opt.mTid = mTid;
     }
     mExecutor->execute(std::move(queue), 0, opt);
-    notify();
   }
   auto execute(WorkerJobQueue&& queue, std::size_t count, ExeOpt opt) noexcept -> void
   {
-    if (opt.mOpt == ExeOpt::PreferInOne) [[unlikely]] {
+    if (opt.inCurrent()) [[unlikely]] {
       opt.mTid = mTid;
     }
     mExecutor->execute(std::move(queue), count, opt);
-    notify();
   }
   auto execute(WorkerJob* job, ExeOpt opt) noexcept -> void
   {
-    if (opt.mOpt == ExeOpt::PreferInOne) [[unlikely]] {
+    if (opt.inCurrent()) [[unlikely]] {
       opt.mTid = mTid;
     }
     mExecutor->execute(job, opt);
-    notify();
   }
-  auto addTimer(Instant time, WorkerJob* job) noexcept -> void { mTimerManager.addTimer(time, job); }
+  // cooperative budget of the jobs run between two polls of io and timers, unlimited unless an executor refills it
+  auto refillBudget(std::uint32_t jobs, Duration time) noexcept -> void
+  {
+    mBudgetLeft = jobs == 0 ? kUnlimitedBudget : jobs;
+    mBudgetDeadline = time == Duration::zero() ? Instant::max() : std::chrono::steady_clock::now() + time;
+  }
+  // takes one job from the budget, returns whether it is used up
+  auto consumeBudget() noexcept -> bool
+  {
+    mBudgetLeft -= mBudgetLeft > 0;
+    return mBudgetLeft == 0 || (mBudgetLeft % kBudgetClockInterval == 0 && overBudget());
+  }
+  auto overBudget() const noexcept -> bool
+  {
+    return mBudgetLeft == 0 ||
+           (mBudgetDeadline != Instant::max() && std::chrono::steady_clock::now() >= mBudgetDeadline);
+  }
+
+  // `owner`, if given, tracks the proactor the timer is on until it expires, see `cancelTimer()`
+  auto addTimer(Instant time, WorkerJob* job, TimerOwner* owner = nullptr) noexcept -> void
+  {
+    if (owner != nullptr) {
+      owner->store(this, std::memory_order_release);
+    }
+    mTimerManager.addTimer(time, job, owner);
+  }
   auto deleteTimer(void* jobId) noexcept -> void { mTimerManager.deleteTimer(jobId); }
   auto processTimers() { return mTimerManager.processTimers(); }
+  // hands all timers to `target`, e.g. when this thread winds down. Cancels of timers which are queued here are
+  // applied first and their jobs returned, later ones find the new owner in `cancelTimer()`.
+  auto moveTimers(Proactor& target) -> WorkerJobQueue
+  {
+    auto canceled = WorkerJobQueue();
+    std::lock_guard lock(mCancelMt);
+    std::erase_if(mCancels, [&](CancelItem const& cancel) {
+      if (cancel.mKind != CancelItem::Kind::Timer) {
+        return false;
+      }
+      if (mTimerManager.cancelTimer((WorkerJob*)cancel.mToken)) {
+        canceled.pushBack((WorkerJob*)cancel.mToken);
+      }
+      return true;
+    });
+    auto timers = mTimerManager.takeAll();
+    for (auto const& timer : timers) {
+      target.addTimer(timer.instant, timer.job, timer.owner);
+    }
+    if (!timers.empty()) {
+      target.notify();
+    }
+    return canceled;
+  }
+  // queues the cancel of the timer of `job` on whichever proactor `owner` has by now. Returns that proactor, a cancel
+  // which is still queued must be dropped there.
+  static auto cancelTimer(TimerOwner& owner, WorkerJob* job) -> Proactor&
+  {
+    while (true) {
+      auto proactor = owner.load(std::memory_order_acquire);
+      std::lock_guard lock(proactor->mCancelMt);
+      // `moveTimers()` changes the owner under the lock of the old one
+      if (owner.load(std::memory_order_relaxed) == proactor) {
+        proactor->mCancels.push_back(CancelItem::cancelTimer(job));
+        proactor->notify();
+        return *proactor;
+      }
+    }
+  }
 
-  auto notify() -> void
+  // completions of io awaiters and expired timers resume their jobs through the executor instead of on this thread,
+  // so that a thread which is winding down doesn't pick up new work
+  auto setForwarding(bool forwarding) noexcept -> void { mForwarding = forwarding; }
+  auto forwarding() const noexcept -> bool { return mForwarding; }
+  // no io in flight, no timers and no direct descriptors, the ring can be released
+  auto idle() -> bool
   {
-    bool expected = false;
-    if (mNotifyBlocked.compare_exchange_strong(expected, true)) {
+    {
+      std::lock_guard lock(mPendingSet);
+      if (!mPendingJobs.empty()) {
+        return false;
+      }
+    }
+    return !posted() && mTimerManager.empty() && mDirectFiles == 0;
+  }
+  // gives the io_uring instance back while the thread has no use for it, requires idle(). notify() stays safe.
+  auto releaseRing() noexcept -> void
+  {
+    if (mRecvBuffers != nullptr) {
+      mRecvBuffers->detach();
+    }
+    mUring.close();
+  }
+  auto acquireRing() -> void
+  {
+    mUring.open();
+    if (mBuffers != nullptr) {
+      mBuffers->registerWith(mUring);
+    }
+    if (mRecvBuffers != nullptr) {
+      mRecvBuffers->registerWith(mUring);
+    }
+  }
+
+  // the buffers registered with this thread's ring, set up on first use
+  auto buffers() -> BufferPool&
+  {
+    if (mBuffers == nullptr) [[unlikely]] {
+      mBuffers = BufferPool::create();
+      mBuffers->registerWith(mUring);
+    }
+    return *mBuffers;
+  }
+  // `buf` may be used with the fixed operations of this ring. A coroutine can move to another thread between leasing
+  // and using a buffer, the awaiters then take the plain path.
+  auto ownsRegistered(FixedBuffer const& buf) const noexcept -> bool
+  {
+    return buf && buf.pool() == mBuffers.get() && mBuffers->registered();
+  }
+  // the buffers provided to this thread's ring for recvs which select their buffer, set up on first use
+  auto bufferRing() -> BufferRing&
+  {
+    if (mRecvBuffers == nullptr) [[unlikely]] {
+      mRecvBuffers = BufferRing::create();
+      mRecvBuffers->registerWith(mUring);
+    }
+    return *mRecvBuffers;
+  }
+  // accepts and opens can install their file into the file table of this ring, see `adoptDirect()`
+  auto directFiles() const noexcept -> bool { return mUring.fileTable(); }
+  // a direct descriptor was installed into this ring's table, on the owner thread. Direct descriptors live only in the
+  // ring which installed them, so the ring isn't released while there are any.
+  auto adoptDirect() noexcept -> void { mDirectFiles++; }
+  // MT-Safe, frees the direct descriptor `slot` of this ring without waiting for the close
+  auto closeDirect(int slot) -> void
+  {
+    std::lock_guard lock(mPostMt);
+    mClosedSlots.push_back(slot);
+    notify();
+  }
+  // MT-Safe, runs `job` on the owner thread before it polls its ring the next time. Operations on direct descriptors
+  // are submitted this way when the coroutine runs on another thread.
+  auto post(WorkerJob* job) -> void
+  {
+    std::lock_guard lock(mPostMt);
+    mPosted.pushBack(job);
+    notify();
+  }
+
+  // flags of the cqe whose job is running, e.g. the buffer a recv selected. Only valid before the job suspends again.
+  auto cqeFlags() const noexcept -> std::uint32_t { return mCqeFlags; }
+
+  // wakes the owner thread if it is parked in wait(), returns whether it wrote to the eventfd. Notifying a thread
+  // which is running or already notified costs no syscall.
+  auto notify() -> bool
+  {
+    if (!claimWakeup()) {
+      return false;
+    }
+    mUring.notify();
+    return true;
+  }
+  // same as notify(), but posts the wakeup from `sender`'s ring with IORING_OP_MSG_RING when both rings support it.
+  // `sender` must be the calling thread's proactor and must be polled by it.
+  auto notify(Proactor& sender) -> bool
+  {
+    if (!claimWakeup()) {
+      return false;
+    }
+    if (&sender == this || !sender.mUring.msgRingSupported() || !mUring.msgRingSupported()) {
       mUring.notify();
+      return true;
     }
+    sender.mUring.prepMsgRing((Token)tagged(this, kWakeFailedTag), mUring.ringFd(), 0);
+    sender.mUring.submit();
+    return true;
   }
+  // hands `job` to this proactor's thread in the cqe which wakes it up, so it needs no shared queue. Only done if
+  // the thread is parked and both rings support IORING_OP_MSG_RING, returns false otherwise and the caller keeps
+  // the job. Same requirements on `sender` as notify(Proactor&).
+  auto handOver(Proactor& sender, WorkerJob* job) -> bool
+  {
+    if (&sender == this || !sender.mUring.msgRingSupported() || !mUring.msgRingSupported() || !parked()) {
+      return false;
+    }
+    // not claimed: if posting fails the sender runs the job itself and we must stay wakeable
+    auto data = tagged(job, kRemoteJobTag);
+    sender.mUring.prepMsgRing((Token)data, mUring.ringFd(), data);
+    sender.mUring.submit();
+    return true;
+  }
+  auto parked() const noexcept -> bool { return !mNotifyBlocked.load(std::memory_order_relaxed); }
   auto prepRecv(Token token, int fd, std::span<std::byte> buf, int flag = 0) -> void
   {
     addPendingSet((WorkerJob*)token);
     mUring.prepRecv(token, fd, buf, flag);
   }
+  auto prepRecvSelect(Token token, int fd, std::uint16_t group) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepRecvSelect(token, fd, group);
+  }
+  // the job runs for every cqe, see `pending()`
+  auto prepRecvMultishot(Token token, int fd, std::uint16_t group) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepRecvMultishot(token, fd, group);
+  }
   auto prepSend(Token token, int fd, std::span<std::byte const> buf, int flag = 0) -> void
   {
     addPendingSet((WorkerJob*)token);
@@ -92,12 +287,41 @@ public:
     addPendingSet((WorkerJob*)token);
     mUring.prepConnect(token, fd, addr, addrlen);
   }
+  // requires `directFiles()`, the result is a slot of this ring's table
+  auto prepAcceptDirect(Token token, int fd) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepAcceptDirect(token, fd);
+  }
+  auto prepAcceptMtDirect(Token token, int fd) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepAcceptMtDirect(token, fd);
+  }
+  auto prepOpenAt(Token token, char const* path, int flags, mode_t mode) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepOpenAt(token, path, flags, mode);
+  }
+  auto prepOpenAtDirect(Token token, char const* path, int flags, mode_t mode) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepOpenAtDirect(token, path, flags, mode);
+  }
+  // the fd of the sqe prepped last is a direct descriptor of this ring
+  auto fixedFile() noexcept -> void { mUring.fixedFile(); }
   template <typename Rep, typename Period>
   auto prepTimeout(Token token, std::chrono::duration<Rep, Period> duration) -> void
   {
     addPendingSet((WorkerJob*)token);
     mUring.prepAddTimeout(token, duration);
   }
+  // `spec` is read when the sqe is submitted, it must live until the timeout completes
+  auto prepTimeout(Token token, __kernel_timespec* spec) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepTimeout(token, spec);
+  }
   template <typename Rep, typename Period>
   auto prepUpdateTimeout(Token token, std::chrono::duration<Rep, Period> duration) -> void
   {
@@ -125,9 +349,42 @@ public:
     addPendingSet((WorkerJob*)token);
     mUring.prepWrite(token, fd, buf, offset);
   }
+  // requires `ownsRegistered()` of the buffer `index` belongs to
+  auto prepReadFixed(Token token, int fd, std::span<std::byte> buf, off_t offset, int index) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepReadFixed(token, fd, buf, offset, index);
+  }
+  auto prepWriteFixed(Token token, int fd, std::span<std::byte const> buf, off_t offset, int index) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepWriteFixed(token, fd, buf, offset, index);
+  }
+  // the job runs for both cqes, see `pending()`
+  auto prepSendZcFixed(Token token, int fd, std::span<std::byte const> buf, int index) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepSendZcFixed(token, fd, buf, index);
+  }
+  // the operation of `job` has more cqes to come. Multishot cqes run the job without taking it out of the pending set.
+  auto pending(WorkerJob* job) -> bool
+  {
+    std::lock_guard lock(mPendingSet);
+    return mPendingJobs.contains(job);
+  }
   auto prepCancel(int fd) -> void { mUring.prepCancel(fd); }
   auto prepCancel(Token token) -> void { mUring.prepCancel(token); }
-  auto prepClose(Token token, int fd) -> void { mUring.prepClose(token, fd); }
+  auto prepClose(Token token, int fd) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepClose(token, fd);
+  }
+  auto prepCloseDirect(Token token, int slot) -> void
+  {
+    addPendingSet((WorkerJob*)token);
+    mUring.prepCloseDirect(token, slot);
+    mDirectFiles--;
+  }
 
   auto addCancel(CancelItem cancel) -> void
   {
@@ -135,29 +392,55 @@ public:
     mCancels.push_back(cancel);
     notify();
   }
+  // takes back a cancel of `token` which wasn't processed yet, because the operation completed in the meantime and a
+  // new one may reuse the token
+  auto dropCancel(Token token) -> void
+  {
+    std::lock_guard lock(mCancelMt);
+    std::erase_if(mCancels, [token](CancelItem const& item) {
+      return item.mKind != CancelItem::Kind::IoFd && item.mToken == token;
+    });
+  }
 
-  auto wait() -> void
+  auto wait() -> bool { return wait([] { return false; }); }
+  // parks until io completes, a timer expires or notify() is called, unless `ready()` finds work after the
+  // thread is marked as parked. Returns whether it blocked in the kernel.
+  template <typename Fn>
+  auto wait(Fn&& ready) -> bool
   {
+    processPosted();
     processCancel();
-    auto [jobs, count] = mTimerManager.processTimers();
-    while (auto job = jobs.popFront()) {
-      runJob(job, {.ptr = nullptr});
-    }
-    if (mNotifyBlocked.load(std::memory_order_acquire)) { // unblocked path
+    runTimers();
+    mNotifyBlocked.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ready() || posted()) {
+      // a notify() which raced with us leaves one spurious cqe behind, the next wait() eats it
+      mNotifyBlocked.store(true, std::memory_order_relaxed);
       submit();
       processIoTasks();
-      mNotifyBlocked.store(false, std::memory_order_release);
-    } else {
-      auto future = mTimerManager.nextInstant();
-      auto duration = future - std::chrono::steady_clock::now();
-      mNotifyBlocked.store(false, std::memory_order_relaxed);
-      std::atomic_thread_fence(std::memory_order_acq_rel);
-      submitWait(duration);
-      processIoTasks();
-      std::atomic_thread_fence(std::memory_order_acq_rel);
-      mNotifyBlocked.store(true, std::memory_order_relaxed);
+      return false;
     }
-    return;
+    auto duration = mTimerManager.nextInstant() - std::chrono::steady_clock::now();
+    submitWait(duration);
+    submit(); // collect the rest of the completions without entering the kernel again
+    processIoTasks();
+    mNotifyBlocked.store(true, std::memory_order_release);
+    return true;
+  }
+
+  // non-blocking version of wait(), only enters the kernel if sqes are queued
+  auto poll() -> void
+  {
+    processPosted();
+    processCancel();
+    runTimers();
+    submit();
+    processIoTasks();
+  }
+  // completions or expired timers are waiting, checked without a syscall
+  auto ready() const noexcept -> bool
+  {
+    return mUring.ready() > 0 || mTimerManager.nextInstant() <= std::chrono::steady_clock::now();
   }
 
   auto delPendingSet(CancelItem item) -> void
@@ -165,6 +448,8 @@ public:
     std::lock_guard lock(mPendingSet);
     switch (item.mKind) {
     case CancelItem::Kind::IoFd:
+    case CancelItem::Kind::IoToken:
+    case CancelItem::Kind::Timer:
       break;
     case CancelItem::Kind::TimeoutToken:
       mPendingJobs.erase((WorkerJob*)item.mToken);
@@ -214,9 +499,22 @@ private:
     mUring.advance(count);
   }
 
+  auto runTimers() -> void
+  {
+    auto [jobs, count] = mTimerManager.processTimers();
+    if (mForwarding && !jobs.empty()) [[unlikely]] {
+      mExecutor->execute(std::move(jobs), count, ExeOpt::balance());
+      return;
+    }
+    while (auto job = jobs.popFront()) {
+      runJob(job, {.ptr = nullptr});
+    }
+  }
+
   auto processIoTasks() -> void
   {
     for (IoTask const& task : mIoTaskBuffer) {
+      mCqeFlags = task.flags;
       runJob(task.job, {.i32 = task.res});
     }
     mIoTaskBuffer.clear();
@@ -224,16 +522,60 @@ private:
 
   auto processCancel() -> void
   {
-    std::lock_guard lock(mCancelMt);
-    if (!mCancels.empty()) [[unlikely]] {
+    auto canceled = WorkerJobQueue();
+    {
+      std::lock_guard lock(mCancelMt);
+      if (mCancels.empty()) [[likely]] {
+        return;
+      }
       while (!mCancels.empty()) {
         auto cancel = mCancels.back();
         mCancels.pop_back();
-        doCancel(cancel);
+        if (cancel.mKind == CancelItem::Kind::Timer) {
+          if (mTimerManager.cancelTimer((WorkerJob*)cancel.mToken)) {
+            canceled.pushBack((WorkerJob*)cancel.mToken);
+          }
+        } else {
+          doCancel(cancel);
+        }
       }
       auto r = mUring.submit();
       assert(r == std::errc(0));
     }
+    // outside of the lock, the jobs may queue new cancels
+    if (mForwarding && !canceled.empty()) [[unlikely]] {
+      mExecutor->execute(std::move(canceled), 0, ExeOpt::balance());
+      return;
+    }
+    while (auto job = canceled.popFront()) {
+      runJob(job, kWorkerArgNull);
+    }
+  }
+
+  // a post() which came after processPosted() doesn't wake us, it is seen here
+  auto posted() -> bool
+  {
+    std::lock_guard lock(mPostMt);
+    return !mPosted.empty() || !mClosedSlots.empty();
+  }
+  auto processPosted() -> void
+  {
+    auto posted = WorkerJobQueue();
+    {
+      std::lock_guard lock(mPostMt);
+      if (mPosted.empty() && mClosedSlots.empty()) [[likely]] {
+        return;
+      }
+      posted = std::move(mPosted);
+      for (auto slot : mClosedSlots) {
+        mUring.prepCloseDirect(nullptr, slot);
+        mDirectFiles--;
+      }
+      mClosedSlots.clear();
+    }
+    while (auto job = posted.popFront()) {
+      runJob(job, kWorkerArgNull);
+    }
   }
 
   auto addPendingSet(WorkerJob* job) -> void
@@ -247,12 +589,17 @@ private:
     if (cqe->user_data == 0) {
 
     } else {
+      mCqeFlags = cqe->flags;
       runJob((WorkerJob*)cqe->user_data, {.i32 = cqe->res});
     }
   }
 
   auto addIoJob(::io_uring_cqe* cqe) noexcept -> void
   {
+    if (cqe->user_data & kMsgRingTagMask) [[unlikely]] {
+      addMsgRing(cqe);
+      return;
+    }
     auto job = (WorkerJob*)cqe->user_data;
     if (job != nullptr) {
       auto n = 0;
@@ -261,14 +608,41 @@ private:
         n = mPendingJobs.erase(job);
       }
       if (n == 1) {
-        auto r = mIoTaskBuffer.push_back({job, cqe->res});
+        auto r = mIoTaskBuffer.push_back({job, cqe->res, cqe->flags});
         if (r == false) { // task buffer full
+          mCqeFlags = cqe->flags;
           runJob(job, {.i32 = cqe->res});
         }
       }
     }
   }
 
+  auto addMsgRing(::io_uring_cqe* cqe) noexcept -> void
+  {
+    auto ptr = cqe->user_data & ~kMsgRingTagMask;
+    if (cqe->user_data & kRemoteJobTag) {
+      // handed over by another thread, or handing it over failed and it runs on the sender. Queued like any other job
+      // instead of run right away, so that it keeps its class, deadline and shedding.
+      execute((WorkerJob*)ptr, ExeOpt::yield());
+    } else if (cqe->user_data & kWakeFailedTag) {
+      ((Proactor*)ptr)->mUring.notify();
+    }
+  }
+  auto claimWakeup() noexcept -> bool
+  {
+    // pairs with the fence in wait(): either the waiter sees the new work or we see it parked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mNotifyBlocked.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    bool expected = false;
+    return mNotifyBlocked.compare_exchange_strong(expected, true);
+  }
+  static auto tagged(void const* ptr, std::uint64_t tag) noexcept -> std::uint64_t
+  {
+    return reinterpret_cast<std::uint64_t>(ptr) | tag;
+  }
+
   auto doCancel(CancelItem item) noexcept -> void
   {
     switch (item.mKind) {
@@ -278,25 +652,52 @@ private:
     case CancelItem::Kind::TimeoutToken:
       mUring.prepRemoveTimeout(item.mToken);
       break;
+    case CancelItem::Kind::IoToken:
+      mUring.prepAsyncCancel(item.mToken);
+      break;
+    case CancelItem::Kind::Timer:
+      break; // not an io, see processCancel()
     }
   }
 
+  // low bits of user_data of cqes posted with IORING_OP_MSG_RING, tagged pointers are at least 8 bytes aligned
+  constexpr static std::uint64_t kRemoteJobTag = 1;  // a WorkerJob to run on this thread
+  constexpr static std::uint64_t kWakeFailedTag = 2; // posting a wakeup to this Proactor failed
+  constexpr static std::uint64_t kMsgRingTagMask = kRemoteJobTag | kWakeFailedTag;
+
+  constexpr static std::uint32_t kUnlimitedBudget = std::numeric_limits<std::uint32_t>::max();
+  // the clock is read once every this many jobs
+  constexpr static std::uint32_t kBudgetClockInterval = 16;
+
   struct IoTask {
     WorkerJob* job;
     int res;
+    std::uint32_t flags;
   };
   util::FixedVec<IoTask, 36> mIoTaskBuffer;
 
   Executor* mExecutor;
   TimerManager mTimerManager{64};
   IoUring mUring{};
+  std::shared_ptr<BufferPool> mBuffers;
+  std::shared_ptr<BufferRing> mRecvBuffers;
+  std::uint32_t mCqeFlags = 0;
+  std::uint32_t mDirectFiles = 0; // slots of the file table in use, only touched by the owner
+
+  std::mutex mPostMt;
+  WorkerJobQueue mPosted;
+  std::vector<int> mClosedSlots;
 
   std::mutex mPendingSet;
   std::unordered_set<WorkerJob*> mPendingJobs;
 
   std::mutex mCancelMt;
   std::vector<CancelItem> mCancels;
-  std::atomic_bool mNotifyBlocked{false};
+  // false only while the owner is parked in wait() and nobody notified it yet
+  std::atomic_bool mNotifyBlocked{true};
   std::uint32_t mTid = -1;
+  bool mForwarding = false;
+  std::uint32_t mBudgetLeft = kUnlimitedBudget;
+  Instant mBudgetDeadline = Instant::max();
 };
 } // namespace coco
\ No newline at end of file
@@ -3,23 +3,40 @@
 #include "coco/blocking_executor.hpp"
 #include "coco/inl_executor.hpp"
 #include "coco/mt_executor.hpp"
+#include "coco/parallel.hpp"
 #include "coco/sync/chain.hpp"
+#include "coco/sys/socket_awaiters.hpp"
+#include "coco/task_group.hpp"
+#include "coco/tpc_executor.hpp"
+#include "coco/when.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <ranges>
 
 namespace coco {
 enum class RuntimeKind {
   Inline,
   Multi,
+  PerCore, // shared-nothing thread per core, see `TpcExecutor`
 };
 constexpr inline RuntimeKind MT = RuntimeKind::Multi;
 constexpr inline RuntimeKind INL = RuntimeKind::Inline;
+constexpr inline RuntimeKind TPC = RuntimeKind::PerCore;
 class Runtime {
+  class SpawnBatches;
+
 public:
-  constexpr Runtime(RuntimeKind type, std::size_t threadNum = 4) : mBlockingThreadsMax(500), mBlocking(nullptr)
+  constexpr Runtime(RuntimeKind type, std::size_t threadNum = 4, MtOpt opt = {})
+      : mBlockingThreadsMax(500), mBlocking(nullptr)
   {
     if (type == RuntimeKind::Inline) {
       mExecutor = std::make_shared<InlExecutor>();
     } else if (type == RuntimeKind::Multi) {
-      mExecutor = std::make_shared<MtExecutor>(threadNum);
+      mExecutor = std::make_shared<MtExecutor>(threadNum, opt);
+    } else if (type == RuntimeKind::PerCore) {
+      mExecutor = std::make_shared<TpcExecutor>(threadNum, opt);
     }
   }
 
@@ -50,6 +67,18 @@ public:
       mDone = &mTask.promise().getNextJob();
       Proactor::get().execute(mTask.promise().getThisJob(), ExeOpt::balance());
     }
+    JoinHandle(TaskTy&& task, Executor& executor, ExeOpt opt) noexcept : mTask(std::forward<TaskTy>(task))
+    {
+      mTask.promise().setNextJob(&detail::kEmptyJob);
+      mDone = &mTask.promise().getNextJob();
+      executor.execute(mTask.promise().getThisJob(), opt);
+    }
+    JoinHandle(TaskTy&& task, SpawnBatches& batches) noexcept : mTask(std::forward<TaskTy>(task))
+    {
+      mTask.promise().setNextJob(&detail::kEmptyJob);
+      mDone = &mTask.promise().getNextJob();
+      batches.push(mTask.promise().getThisJob());
+    }
     JoinHandle(JoinHandle&& other) noexcept
         : mDone(std::exchange(other.mDone, nullptr)), mTask(std::move(other.mTask)){};
     auto operator=(JoinHandle&& other) noexcept -> JoinHandle& = default;
@@ -72,6 +101,49 @@ public:
   {
     return JoinHandle<TaskTy>(std::move(task));
   }
+  // run ahead of the tasks without a deadline in its `Priority` class, earliest deadline first
+  template <TaskConcept TaskTy>
+  [[nodiscard]] auto spawn(TaskTy&& task, Deadline deadline) -> JoinHandle<TaskTy>
+  {
+    return JoinHandle<TaskTy>(std::move(task).withDeadline(deadline));
+  }
+
+  // runs `task` on worker, or core, `tid` and keeps it there. With `TPC` the only way to hand work to another core,
+  // the awaiting side stays on its own core and is sent back there once the task is done.
+  template <TaskConcept TaskTy>
+  [[nodiscard]] auto spawnOn(std::uint32_t tid, TaskTy&& task) -> JoinHandle<TaskTy>
+  {
+    return JoinHandle<TaskTy>(std::move(task), *mExecutor, ExeOpt::on(std::uint16_t(tid)));
+  }
+
+  // spawn every task of `tasks`, dealt round-robin over the workers in one pass. Each worker gets its share in batches,
+  // with one enqueue and at most one wakeup per batch instead of one per task, see `SpawnBatches`.
+  template <std::ranges::input_range Range, typename TaskTy = std::ranges::range_value_t<Range>>
+    requires TaskConcept<TaskTy>
+  [[nodiscard]] auto spawnBatch(Range&& tasks) -> std::vector<JoinHandle<TaskTy>>
+  {
+    auto handles = std::vector<JoinHandle<TaskTy>>();
+    if constexpr (std::ranges::sized_range<Range>) {
+      handles.reserve(std::ranges::size(tasks));
+    }
+    auto batches = SpawnBatches(*mExecutor);
+    for (auto&& task : tasks) {
+      handles.push_back(JoinHandle<TaskTy>(std::move(task), batches));
+    }
+    return handles;
+  }
+  // like `spawnBatch()` for detached tasks
+  template <std::ranges::input_range Range>
+    requires std::is_same_v<std::ranges::range_value_t<Range>, Task<>>
+  auto spawnMany(Range&& tasks) -> void
+  {
+    auto batches = SpawnBatches(*mExecutor);
+    for (auto&& task : tasks) {
+      task.promise().setDetach();
+      batches.push(task.promise().getThisJob());
+      [[maybe_unused]] auto dummy = task.take();
+    }
+  }
 
   template <typename TaskTy>
   [[nodiscard]] auto waitAll(std::span<JoinHandle<TaskTy>> handles) -> Task<>
@@ -93,35 +165,78 @@ public:
     co_return;
   }
 
+  // runs the tasks as one `TaskGroup`, the first exception stops the tasks which didn't start yet and is rethrown
   template <TaskConcept... TasksTy>
   [[nodiscard]] auto waitAll(TasksTy&&... tasks) -> Task<>
   {
-    auto tasksTuple = std::make_tuple(std::forward<TasksTy>(tasks)...);
-    constexpr auto taskCount = std::tuple_size_v<decltype(tasksTuple)>;
-    auto joinHandles = std::vector<JoinHandle<Task<>>>();
-    joinHandles.reserve(taskCount);
-    std::apply([&](auto&&... task) { (joinHandles.push_back(spawn(std::move(task))), ...); }, tasksTuple);
-    co_return co_await waitAll(joinHandles);
+    auto group = TaskGroup();
+    (group.spawn(std::forward<TasksTy>(tasks)), ...);
+    co_await group.join();
   }
 
   auto block(Task<> task) -> void { mExecutor->runMain(std::move(task)); }
 
+  auto executor() const noexcept -> Executor* { return mExecutor.get(); }
+
+  auto topologyReport() const -> std::string
+  {
+    if (auto mt = dynamic_cast<MtExecutor const*>(mExecutor.get()); mt != nullptr) {
+      return mt->topologyReport();
+    }
+    if (auto tpc = dynamic_cast<TpcExecutor const*>(mExecutor.get()); tpc != nullptr) {
+      return "TpcExecutor: " + std::to_string(tpc->concurrency()) + " cores\n";
+    }
+    return "InlExecutor: 1 worker on the calling thread\n";
+  }
+  // resizes a multi-threaded runtime within `MtOpt::mMinThreads` and `MtOpt::mMaxThreads`, returns the new count
+  auto setWorkerCount(std::size_t count) -> std::size_t
+  {
+    if (auto mt = dynamic_cast<MtExecutor*>(mExecutor.get()); mt != nullptr) {
+      return mt->setWorkerCount(count);
+    }
+    return mExecutor->concurrency();
+  }
+  auto workerCount() const noexcept -> std::size_t { return mExecutor->concurrency(); }
+  // snapshot of the per worker scheduler counters, see `coco::WorkerStats`. The inline runtime keeps none.
+  auto stats() const -> RuntimeStats
+  {
+    if (auto mt = dynamic_cast<MtExecutor const*>(mExecutor.get()); mt != nullptr) {
+      return mt->stats();
+    }
+    if (auto tpc = dynamic_cast<TpcExecutor const*>(mExecutor.get()); tpc != nullptr) {
+      return tpc->stats();
+    }
+    return RuntimeStats{};
+  }
+
   struct [[nodiscard]] SleepAwaiter {
     SleepAwaiter(Instant instant) : mInstant(instant) {}
+    SleepAwaiter(SleepAwaiter&& other) noexcept : mInstant(other.mInstant) {}
 
     auto await_ready() const noexcept -> bool { return false; }
     template <typename Promise>
     auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
     {
-      auto job = handle.promise().getThisJob();
-      mPromise = &handle.promise();
-      Proactor::get().addTimer(mInstant, job);
+      suspend(handle.promise());
+    }
+    auto suspend(PromiseBase& promise) noexcept -> void
+    {
+      mPromise = &promise;
+      Proactor::get().addTimer(mInstant, promise.getThisJob(), &mOwner);
     }
     auto await_resume() const noexcept -> void {}
+    // wakes the sleeper early. The timer may have moved on from the proactor it suspended on when that worker
+    // retired, the cancel goes to the one which has it now. Returns where the cancel is queued and its token.
+    auto cancel(Proactor& /* owner */) noexcept -> std::pair<Proactor*, Token>
+    {
+      auto job = mPromise->getThisJob();
+      return {&Proactor::cancelTimer(mOwner, job), job};
+    }
 
   private:
     PromiseBase* mPromise;
     Instant mInstant;
+    TimerOwner mOwner{nullptr};
   };
   template <typename Rep, typename Period>
   auto sleepFor(std::chrono::duration<Rep, Period> duration) -> Task<>
@@ -132,6 +247,20 @@ public:
     auto now = std::chrono::steady_clock::now();
     co_await SleepAwaiter(now + std::chrono::duration_cast<Duration>(duration));
   }
+  // sleeps on the io_uring of the thread instead of its timers, so that a stop of `token` cuts it short. Returns
+  // `operation_canceled` if it did.
+  template <typename Rep, typename Period>
+  auto sleepFor(std::chrono::duration<Rep, Period> duration, CancellationToken token) -> Task<std::errc>
+  {
+    if (token.stopRequested()) {
+      co_return std::errc::operation_canceled;
+    }
+    if (duration.count() == 0) {
+      co_return std::errc(0);
+    }
+    co_return co_await sys::detail::CancelAwaiter<sys::detail::TimeoutAwaiter>(
+        token, std::chrono::duration_cast<Duration>(duration));
+  }
   auto sleepUntil(Instant time) -> Task<>
   {
     auto now = std::chrono::steady_clock::now();
@@ -204,6 +333,13 @@ public:
     mExecutor.get()->execute(task.promise().getThisJob(), ExeOpt::balance());
     [[maybe_unused]] auto dummy = task.take();
   }
+  auto spawnDetach(Task<> task, Deadline deadline) -> void { spawnDetach(std::move(task).withDeadline(deadline)); }
+  auto spawnDetachOn(std::uint32_t tid, Task<> task) -> void
+  {
+    task.promise().setDetach();
+    mExecutor.get()->execute(task.promise().getThisJob(), ExeOpt::on(std::uint16_t(tid)));
+    [[maybe_unused]] auto dummy = task.take();
+  }
 
   struct [[nodiscard]] waitChainAwaiter {
     waitChainAwaiter(Runtime& runtime, sync::Chain&& chain) noexcept : mRuntime(runtime), mChain(std::move(chain)) {}
@@ -213,7 +349,8 @@ public:
     auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
     {
       mChain.chain(handle.promise().getThisJob());
-      mRuntime.execute(mChain.takeQueue(), ExeOpt::balance());
+      // chained jobs must not be stolen by other workers
+      mRuntime.execute(mChain.takeQueue(), ExeOpt::forceInOne());
     }
     auto await_resume() const noexcept -> void {}
     Runtime& mRuntime;
@@ -222,7 +359,105 @@ public:
 
   auto wait(sync::Chain&& chain) -> decltype(auto) { return waitChainAwaiter(*this, std::move(chain)); }
 
+  // Data parallel loops over a random access range, split into chunks of `grain` elements which idle workers steal.
+  // Awaiting one suspends the caller instead of blocking its worker, the caller runs chunks itself meanwhile. The
+  // range must outlive the returned task.
+  template <std::ranges::random_access_range Range, typename Fn>
+  [[nodiscard]] auto parallelFor(Range&& range, std::size_t grain, Fn fn) -> Task<>
+  {
+    auto const first = std::ranges::begin(range);
+    auto const size = std::size_t(std::ranges::distance(range));
+    grain = std::max<std::size_t>(grain, 1);
+    co_await detail::forkJoin((size + grain - 1) / grain, [&](std::size_t chunk) {
+      auto it = first + chunk * grain;
+      auto const last = first + std::min(size, (chunk + 1) * grain);
+      for (; it != last; ++it) {
+        fn(*it);
+      }
+    });
+  }
+  // `op` must be associative, it is applied within each chunk first and then over the chunk results in order
+  template <std::ranges::random_access_range Range, typename T, typename Op>
+  [[nodiscard]] auto parallelReduce(Range&& range, std::size_t grain, T init, Op op) -> Task<T>
+  {
+    auto const first = std::ranges::begin(range);
+    auto const size = std::size_t(std::ranges::distance(range));
+    grain = std::max<std::size_t>(grain, 1);
+    auto partials = std::vector<std::optional<T>>((size + grain - 1) / grain);
+    co_await detail::forkJoin(partials.size(), [&](std::size_t chunk) {
+      auto it = first + chunk * grain;
+      auto const last = first + std::min(size, (chunk + 1) * grain);
+      auto acc = T(*it);
+      for (++it; it != last; ++it) {
+        acc = op(std::move(acc), *it);
+      }
+      partials[chunk].emplace(std::move(acc));
+    });
+    for (auto& partial : partials) {
+      init = op(std::move(init), std::move(*partial));
+    }
+    co_return init;
+  }
+  // sorts the chunks in parallel, then merges neighbours pairwise in rounds of doubling width. The last rounds
+  // have little parallelism, so the speedup levels off at around log2(size / grain).
+  template <std::ranges::random_access_range Range, typename Compare = std::ranges::less>
+  [[nodiscard]] auto parallelSort(Range&& range, std::size_t grain, Compare comp = {}) -> Task<>
+  {
+    auto const first = std::ranges::begin(range);
+    auto const size = std::size_t(std::ranges::distance(range));
+    grain = std::max<std::size_t>(grain, 1);
+    auto const sortChunk = [&](std::size_t chunk) {
+      std::sort(first + chunk * grain, first + std::min(size, (chunk + 1) * grain), comp);
+    };
+    co_await parallelFor(std::views::iota(std::size_t(0), (size + grain - 1) / grain), 1, sortChunk);
+    for (auto width = grain; width < size; width *= 2) {
+      auto const mergePair = [&](std::size_t pair) {
+        auto const lo = pair * 2 * width;
+        auto const mid = std::min(size, lo + width);
+        auto const hi = std::min(size, lo + 2 * width);
+        std::inplace_merge(first + lo, first + mid, first + hi, comp);
+      };
+      co_await parallelFor(std::views::iota(std::size_t(0), (size + 2 * width - 1) / (2 * width)), 1, mergePair);
+    }
+  }
+
 private:
+  // per worker job batches for the bulk spawns, handed over on destruction and whenever each worker has its next
+  // batch. The first batch is a single job, so the workers start right away, then they double up to `kSpawnBatch`:
+  // a worker which drained its batch parks, and with small batches waking it again costs more than it ran.
+  class SpawnBatches {
+  public:
+    explicit SpawnBatches(Executor& executor) : mExecutor(executor), mBatches(executor.concurrency()) {}
+    SpawnBatches(SpawnBatches const&) = delete;
+    auto operator=(SpawnBatches const&) -> SpawnBatches& = delete;
+    ~SpawnBatches() noexcept { flush(); }
+
+    auto push(WorkerJob* job) noexcept -> void
+    {
+      mBatches[mNext].pushBack(job);
+      if (++mNext == mBatches.size()) {
+        mNext = 0;
+        if (++mRounds == mBatchRounds) {
+          flush();
+          mBatchRounds = std::min(mBatchRounds * 2, kSpawnBatch);
+        }
+      }
+    }
+    auto flush() noexcept -> void
+    {
+      mExecutor.executeBatches(mBatches, ExeOpt::balance());
+      mRounds = 0;
+    }
+
+  private:
+    Executor& mExecutor;
+    std::vector<WorkerJobQueue> mBatches;
+    std::size_t mNext = 0;
+    std::uint32_t mRounds = 0;
+    std::uint32_t mBatchRounds = 1;
+  };
+  constexpr static std::uint32_t kSpawnBatch = 4096;
+
   auto execute(WorkerJob* job, ExeOpt opt) noexcept -> void { mExecutor.get()->execute(job, opt); }
   auto execute(WorkerJobQueue queue, ExeOpt opt) noexcept -> void
   {
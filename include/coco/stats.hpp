@@ -0,0 +1,251 @@
+#pragma once
+
+#include "coco/worker_job.hpp" // for kPriorityCount
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace coco {
+#ifdef COCO_STATS
+constexpr inline bool kStatsEnabled = true;
+#else
+constexpr inline bool kStatsEnabled = false;
+#endif
+
+// counts of a power of two histogram, bucket 0 holds 0, bucket i holds [2^(i-1), 2^i) and the last one everything
+// above
+struct Histogram {
+  constexpr static std::size_t kBuckets = 16;
+  std::array<std::uint64_t, kBuckets> mBuckets{};
+
+  constexpr static auto bucketOf(std::uint64_t value) noexcept -> std::size_t
+  {
+    return std::min<std::size_t>(std::bit_width(value), kBuckets - 1);
+  }
+  auto count() const noexcept -> std::uint64_t;
+  // upper bound of the bucket which holds the `p` quantile, p in [0, 1]
+  auto percentile(double p) const noexcept -> std::uint64_t;
+  auto operator+=(Histogram const& other) noexcept -> Histogram&;
+};
+
+struct WorkerStats {
+  std::uint64_t mJobsRun = 0;
+  std::uint64_t mLocalEnqueues = 0;  // pushed by the worker itself
+  std::uint64_t mRemoteEnqueues = 0; // taken from the inboxes or handed over by other threads
+  std::uint64_t mPushFailures = 0;   // local pushes which found the class queue full and went through the inbox
+  std::uint64_t mSteals = 0;
+  std::uint64_t mParks = 0;   // times the worker ran out of work and parked
+  std::uint64_t mUnparks = 0; // wakeups other threads sent it while parked
+  std::uint64_t mParkedUs = 0;
+  std::uint64_t mBusyUs = 0;        // time spent in rounds of jobs
+  std::uint64_t mQueueHighWater = 0; // deepest queued backlog seen at the start of a round
+  Histogram mBatchSizes;             // jobs run per round
+  std::uint64_t mLifoHits = 0;       // jobs run from the lifo slot
+  std::uint64_t mSpinHits = 0;       // idle spins which found work before parking
+  std::uint64_t mSpinMisses = 0;     // idle spins which gave up and parked
+  std::uint64_t mHandOvers = 0;      // jobs other threads passed it inside the IORING_OP_MSG_RING cqe which woke it
+  std::uint64_t mBudgetPolls = 0;    // io and timer polls forced by a used up budget in the middle of a run of jobs
+  std::uint64_t mShedJobs = 0;       // tasks completed with `std::errc::timed_out` instead of being started
+  std::array<std::uint64_t, kPriorityCount> mClassRuns{};   // jobs run per `Priority` class
+  std::array<std::uint64_t, kPriorityCount> mClassWaitUs{}; // time they spent queued, at budget window granularity
+
+  auto operator+=(WorkerStats const& other) noexcept -> WorkerStats&;
+};
+
+struct RuntimeStats {
+  bool mEnabled = kStatsEnabled; // built with COCO_STATS, otherwise everything reads 0
+  std::vector<WorkerStats> mWorkers;
+
+  auto total() const noexcept -> WorkerStats;
+};
+
+namespace detail {
+// a counter written only by its owner thread and read from anywhere. The update is a relaxed load and store, no
+// read-modify-write, and it compiles to nothing without COCO_STATS.
+class StatCounter {
+public:
+#ifdef COCO_STATS
+  auto add(std::uint64_t n = 1) noexcept -> void
+  {
+    mValue.store(mValue.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+  auto raise(std::uint64_t value) noexcept -> void
+  {
+    if (value > mValue.load(std::memory_order_relaxed)) {
+      mValue.store(value, std::memory_order_relaxed);
+    }
+  }
+  auto load() const noexcept -> std::uint64_t { return mValue.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic_uint64_t mValue = 0;
+#else
+  auto add(std::uint64_t = 1) noexcept -> void {}
+  auto raise(std::uint64_t) noexcept -> void {}
+  auto load() const noexcept -> std::uint64_t { return 0; }
+#endif
+};
+
+// same as `StatCounter` for counters which other threads bump too, e.g. the wakeups they send
+class SharedStatCounter {
+public:
+#ifdef COCO_STATS
+  auto add(std::uint64_t n = 1) noexcept -> void { mValue.fetch_add(n, std::memory_order_relaxed); }
+  auto load() const noexcept -> std::uint64_t { return mValue.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic_uint64_t mValue = 0;
+#else
+  auto add(std::uint64_t = 1) noexcept -> void {}
+  auto load() const noexcept -> std::uint64_t { return 0; }
+#endif
+};
+
+class StatHistogram {
+public:
+  auto add(std::uint64_t value) noexcept -> void { mBuckets[Histogram::bucketOf(value)].add(); }
+  auto load() const noexcept -> Histogram
+  {
+    auto histogram = Histogram{};
+    for (std::size_t i = 0; i < Histogram::kBuckets; i++) {
+      histogram.mBuckets[i] = mBuckets[i].load();
+    }
+    return histogram;
+  }
+
+private:
+  std::array<StatCounter, Histogram::kBuckets> mBuckets{};
+};
+
+// the counters behind `WorkerStats` which one worker keeps about itself
+struct WorkerCounters {
+  StatCounter mJobsRun;
+  StatCounter mLocalEnqueues;
+  StatCounter mRemoteEnqueues;
+  StatCounter mPushFailures;
+  StatCounter mSteals;
+  StatCounter mParks;
+  SharedStatCounter mUnparks;
+  StatCounter mParkedUs;
+  StatCounter mBusyUs;
+  StatCounter mQueueHighWater;
+  StatHistogram mBatchSizes;
+  StatCounter mLifoHits;
+  StatCounter mSpinHits;
+  StatCounter mSpinMisses;
+  SharedStatCounter mHandOvers;
+  StatCounter mBudgetPolls;
+  StatCounter mShedJobs;
+  std::array<StatCounter, kPriorityCount> mClassRuns{};
+  std::array<StatCounter, kPriorityCount> mClassWaitUs{};
+
+  auto load() const noexcept -> WorkerStats
+  {
+    auto const loadAll = [](std::array<StatCounter, kPriorityCount> const& counters) {
+      auto values = std::array<std::uint64_t, kPriorityCount>{};
+      for (std::size_t i = 0; i < kPriorityCount; i++) {
+        values[i] = counters[i].load();
+      }
+      return values;
+    };
+    return WorkerStats{
+        .mJobsRun = mJobsRun.load(),
+        .mLocalEnqueues = mLocalEnqueues.load(),
+        .mRemoteEnqueues = mRemoteEnqueues.load(),
+        .mPushFailures = mPushFailures.load(),
+        .mSteals = mSteals.load(),
+        .mParks = mParks.load(),
+        .mUnparks = mUnparks.load(),
+        .mParkedUs = mParkedUs.load(),
+        .mBusyUs = mBusyUs.load(),
+        .mQueueHighWater = mQueueHighWater.load(),
+        .mBatchSizes = mBatchSizes.load(),
+        .mLifoHits = mLifoHits.load(),
+        .mSpinHits = mSpinHits.load(),
+        .mSpinMisses = mSpinMisses.load(),
+        .mHandOvers = mHandOvers.load(),
+        .mBudgetPolls = mBudgetPolls.load(),
+        .mShedJobs = mShedJobs.load(),
+        .mClassRuns = loadAll(mClassRuns),
+        .mClassWaitUs = loadAll(mClassWaitUs),
+    };
+  }
+};
+
+template <typename Duration>
+inline auto toMicros(Duration duration) noexcept -> std::uint64_t
+{
+  return std::uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+} // namespace detail
+
+inline auto Histogram::count() const noexcept -> std::uint64_t
+{
+  auto sum = std::uint64_t(0);
+  for (auto n : mBuckets) {
+    sum += n;
+  }
+  return sum;
+}
+inline auto Histogram::percentile(double p) const noexcept -> std::uint64_t
+{
+  auto const total = count();
+  if (total == 0) {
+    return 0;
+  }
+  auto const rank = std::uint64_t(p * double(total - 1)) + 1;
+  auto seen = std::uint64_t(0);
+  for (std::size_t i = 0; i < kBuckets; i++) {
+    seen += mBuckets[i];
+    if (seen >= rank) {
+      return i == 0 ? 0 : (std::uint64_t(1) << i) - 1;
+    }
+  }
+  return std::uint64_t(1) << (kBuckets - 1);
+}
+inline auto Histogram::operator+=(Histogram const& other) noexcept -> Histogram&
+{
+  for (std::size_t i = 0; i < kBuckets; i++) {
+    mBuckets[i] += other.mBuckets[i];
+  }
+  return *this;
+}
+inline auto WorkerStats::operator+=(WorkerStats const& other) noexcept -> WorkerStats&
+{
+  mJobsRun += other.mJobsRun;
+  mLocalEnqueues += other.mLocalEnqueues;
+  mRemoteEnqueues += other.mRemoteEnqueues;
+  mPushFailures += other.mPushFailures;
+  mSteals += other.mSteals;
+  mParks += other.mParks;
+  mUnparks += other.mUnparks;
+  mParkedUs += other.mParkedUs;
+  mBusyUs += other.mBusyUs;
+  mQueueHighWater = std::max(mQueueHighWater, other.mQueueHighWater);
+  mBatchSizes += other.mBatchSizes;
+  mLifoHits += other.mLifoHits;
+  mSpinHits += other.mSpinHits;
+  mSpinMisses += other.mSpinMisses;
+  mHandOvers += other.mHandOvers;
+  mBudgetPolls += other.mBudgetPolls;
+  mShedJobs += other.mShedJobs;
+  for (std::size_t i = 0; i < kPriorityCount; i++) {
+    mClassRuns[i] += other.mClassRuns[i];
+    mClassWaitUs[i] += other.mClassWaitUs[i];
+  }
+  return *this;
+}
+inline auto RuntimeStats::total() const noexcept -> WorkerStats
+{
+  auto sum = WorkerStats{};
+  for (auto const& worker : mWorkers) {
+    sum += worker;
+  }
+  return sum;
+}
+} // namespace coco
\ No newline at end of file
@@ -11,21 +11,35 @@ template <typename T, std::uint32_t N>
 struct ChannelReadAwaiter {
   auto await_ready() noexcept -> bool { return false; }
   template <typename Promise>
-  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept;
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
+  {
+    return suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> bool;
   auto await_resume() noexcept -> std::optional<T>;
+  // takes a waiting reader off the channel and resumes it without a value, e.g. as the loser of a `whenAny()`
+  auto cancel(Proactor& owner) noexcept -> std::pair<Proactor*, Token>;
 
   std::optional<T> mVal;
   Channel<T, N>& mChannel;
+  WorkerJob* mJob = nullptr;
 };
 template <typename T, std::uint32_t N>
 struct ChannelWriteAwaiter {
   auto await_ready() noexcept -> bool { return false; }
   template <typename Promise>
-  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept;
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
+  {
+    return suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> bool;
   auto await_resume() noexcept -> bool;
+  // same as `ChannelReadAwaiter::cancel()` for a waiting writer
+  auto cancel(Proactor& owner) noexcept -> std::pair<Proactor*, Token>;
 
   T const* mVal;
   Channel<T, N>& mChannel;
+  WorkerJob* mJob = nullptr;
 };
 }; // namespace detail
 
@@ -61,15 +75,15 @@ private:
 
 namespace detail {
 template <typename T, std::uint32_t N>
-template <typename Promise>
-auto ChannelReadAwaiter<T, N>::await_suspend(std::coroutine_handle<Promise> handle) noexcept
+auto ChannelReadAwaiter<T, N>::suspend(PromiseBase& promise) noexcept -> bool
 {
   std::scoped_lock lk(mChannel.mMt);
   if (mChannel.mClosed) {
     return false;
   }
   if (mChannel.mBuffer.empty()) {
-    mChannel.mReaders.pushBack(handle.promise().getThisJob());
+    mJob = promise.getThisJob();
+    mChannel.mReaders.pushBack(mJob);
     WorkerJobQueue tmp;
     for (int i = 0; i < mChannel.mBuffer.size() && !mChannel.mWriter.empty(); i++) {
       tmp.pushBack(mChannel.mWriter.popFront());
@@ -102,18 +116,28 @@ auto ChannelReadAwaiter<T, N>::await_resume() noexcept -> std::optional<T>
   return std::move(mVal);
 }
 
+template <typename T, std::uint32_t N>
+auto ChannelReadAwaiter<T, N>::cancel(Proactor& /* owner */) noexcept -> std::pair<Proactor*, Token>
+{
+  std::scoped_lock lk(mChannel.mMt);
+  if (mChannel.mReaders.remove(mJob)) {
+    Proactor::get().execute(mJob, ExeOpt::prefInOne());
+  }
+  return {nullptr, nullptr};
+}
+
 // ChannelWriteAwaiter
 
 template <typename T, std::uint32_t N>
-template <typename Promise>
-auto ChannelWriteAwaiter<T, N>::await_suspend(std::coroutine_handle<Promise> handle) noexcept
+auto ChannelWriteAwaiter<T, N>::suspend(PromiseBase& promise) noexcept -> bool
 {
   std::scoped_lock lk(mChannel.mMt);
   if (mChannel.mClosed) {
     return false;
   }
   if (mChannel.mBuffer.full()) {
-    mChannel.mWriter.pushBack(handle.promise().getThisJob());
+    mJob = promise.getThisJob();
+    mChannel.mWriter.pushBack(mJob);
     WorkerJobQueue tmp;
     for (int i = 0; i < mChannel.mBuffer.size() && !mChannel.mReaders.empty(); i++) {
       tmp.pushBack(mChannel.mReaders.popFront());
@@ -145,5 +169,15 @@ auto ChannelWriteAwaiter<T, N>::await_resume() noexcept -> bool
   }
   return true;
 }
+
+template <typename T, std::uint32_t N>
+auto ChannelWriteAwaiter<T, N>::cancel(Proactor& /* owner */) noexcept -> std::pair<Proactor*, Token>
+{
+  std::scoped_lock lk(mChannel.mMt);
+  if (mChannel.mWriter.remove(mJob)) {
+    Proactor::get().execute(mJob, ExeOpt::prefInOne());
+  }
+  return {nullptr, nullptr};
+}
 } // namespace detail
 }; // namespace coco::sync
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "coco/sys/direct_awaiters.hpp"
+#include "coco/task.hpp"
+
+namespace coco::sys {
+// A connection held as a direct descriptor, see `DirectFd` and `TcpListener::acceptDirect()`. Any coroutine may use
+// it, operations from another thread than the owner's are submitted by the owner and resume the coroutine there.
+class DirectStream {
+public:
+  DirectStream() noexcept = default;
+  DirectStream(DirectStream&& stream) noexcept = default;
+  auto operator=(DirectStream&& stream) noexcept -> DirectStream& = default;
+
+  static auto from(DirectFd&& fd) noexcept -> DirectStream { return DirectStream(std::move(fd)); }
+  auto direct() const noexcept -> bool { return mFd.direct(); }
+  auto valid() const noexcept -> bool { return mFd.valid(); }
+
+  auto recv(std::span<std::byte> buf) noexcept -> decltype(auto)
+  {
+    return detail::DirectAwaiter<detail::RecvAwaiter>(mFd.fd(), mFd.owner(), buf);
+  }
+  auto send(std::span<std::byte const> buf) noexcept -> decltype(auto)
+  {
+    return detail::DirectAwaiter<detail::SendAwaiter>(mFd.fd(), mFd.owner(), buf);
+  }
+  // into a buffer of the owner's `BufferRing`, see `TcpStream::recv()`
+  auto recv() noexcept -> decltype(auto)
+  {
+    return detail::DirectAwaiter<detail::RecvSelectAwaiter>(mFd.fd(), mFd.owner());
+  }
+  // fixed buffers of the owner's pool take the fixed path, see `Socket::recv(FixedBuffer&)`
+  auto recv(FixedBuffer& buf) noexcept -> decltype(auto)
+  {
+    return detail::DirectAwaiter<detail::ReadFixedAwaiter>(mFd.fd(), mFd.owner(), buf, -1, buf.capacity());
+  }
+  auto send(FixedBuffer const& buf) noexcept -> decltype(auto)
+  {
+    return detail::DirectAwaiter<detail::SendZcAwaiter>(mFd.fd(), mFd.owner(), buf);
+  }
+  // frees the slot with IORING_OP_CLOSE on the owner, dropping the stream does the same without waiting
+  auto close() noexcept -> decltype(auto)
+  {
+    auto [fd, owner] = mFd.release();
+    return detail::DirectAwaiter<detail::CloseDirectAwaiter, false>(fd, owner, owner != nullptr);
+  }
+
+private:
+  explicit DirectStream(DirectFd&& fd) noexcept : mFd(std::move(fd)) {}
+
+  DirectFd mFd;
+};
+
+// A file held as a direct descriptor, opened with IORING_OP_OPENAT into the file table of the calling thread's ring
+class DirectFile {
+public:
+  DirectFile() noexcept = default;
+  DirectFile(DirectFile&& file) noexcept = default;
+  auto operator=(DirectFile&& file) noexcept -> DirectFile& = default;
+
+  // `path` has to live until the file is open
+  static auto open(char const* path, int flags, mode_t mode = 0) -> Task<std::pair<DirectFile, std::errc>>
+  {
+    auto [fd, errc] = co_await detail::OpenDirectAwaiter(path, flags, mode);
+    if (errc != std::errc{0}) {
+      co_return {DirectFile(), errc};
+    }
+    co_return {DirectFile(std::move(fd)), std::errc{0}};
+  }
+  auto direct() const noexcept -> bool { return mFd.direct(); }
+  auto valid() const noexcept -> bool { return mFd.valid(); }
+
+  auto read(std::span<std::byte> buf, off_t offset) noexcept -> decltype(auto)
+  {
+    return detail::DirectAwaiter<detail::ReadAwaiter>(mFd.fd(), mFd.owner(), buf, offset);
+  }
+  auto write(std::span<std::byte const> buf, off_t offset) noexcept -> decltype(auto)
+  {
+    return detail::DirectAwaiter<detail::WriteAwaiter>(mFd.fd(), mFd.owner(), buf, offset);
+  }
+  // see `File::read(FixedBuffer&, off_t, std::size_t)`
+  auto read(FixedBuffer& buf, off_t offset, std::size_t len = -1) noexcept -> decltype(auto)
+  {
+    return detail::DirectAwaiter<detail::ReadFixedAwaiter>(mFd.fd(), mFd.owner(), buf, offset, len);
+  }
+  auto write(FixedBuffer const& buf, off_t offset) noexcept -> decltype(auto)
+  {
+    return detail::DirectAwaiter<detail::WriteFixedAwaiter>(mFd.fd(), mFd.owner(), buf, offset);
+  }
+  auto close() noexcept -> decltype(auto)
+  {
+    auto [fd, owner] = mFd.release();
+    return detail::DirectAwaiter<detail::CloseDirectAwaiter, false>(fd, owner, owner != nullptr);
+  }
+
+private:
+  explicit DirectFile(DirectFd&& fd) noexcept : mFd(std::move(fd)) {}
+
+  DirectFd mFd;
+};
+} // namespace coco::sys
\ No newline at end of file
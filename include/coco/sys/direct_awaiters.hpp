@@ -0,0 +1,176 @@
+#pragma once
+
+#include "coco/sys/direct_fd.hpp"
+#include "coco/sys/file_awaiters.hpp"
+#include "coco/sys/socket_awaiters.hpp"
+
+#include <coroutine>
+#include <type_traits>
+
+namespace coco::sys::detail {
+// `Awaiter`, which preps exactly one sqe on its fd, on a direct descriptor. Only the ring which owns the descriptor can
+// submit it: if the coroutine runs on another thread, the owner preps it in `Proactor::post()` and its completion
+// resumes the coroutine on the owner thread, so the coroutine follows its descriptor. A coroutine of a `TpcExecutor`
+// is sent back to its core instead. `kFixedFile` is false for operations which name the slot themselves.
+template <typename Awaiter, bool kFixedFile = true>
+struct [[nodiscard]] DirectAwaiter : Awaiter, WorkerJob {
+  template <typename... Args>
+  DirectAwaiter(int fd, Proactor* owner, Args&&... args) noexcept
+      : Awaiter(fd, std::forward<Args>(args)...), WorkerJob(&DirectAwaiter::hop, nullptr), mOwner(owner)
+  {
+  }
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
+  {
+    mPromise = &handle.promise();
+    if (mOwner == nullptr || mOwner == &Proactor::get()) [[likely]] {
+      return prep();
+    }
+    if (auto home = mPromise->getThisJob()->home; home != WorkerJob::kNoHome) {
+      this->mIoJob.mOpt = ExeOpt::on(home, ExeOpt::High);
+    }
+    mOwner->post(this);
+    return true;
+  }
+  // not a `whenAny()` branch: its cancel would go to the awaiting thread's ring instead of the owner's
+  auto suspend(PromiseBase& promise) noexcept -> void = delete;
+
+private:
+  // on the owner thread, returns false if nothing was submitted
+  auto prep() noexcept -> bool
+  {
+    if constexpr (std::is_same_v<decltype(Awaiter::suspend(*mPromise)), bool>) {
+      if (!Awaiter::suspend(*mPromise)) {
+        return false;
+      }
+    } else {
+      Awaiter::suspend(*mPromise);
+    }
+    if constexpr (kFixedFile) {
+      if (mOwner != nullptr) {
+        mOwner->fixedFile();
+      }
+    }
+    return true;
+  }
+  static auto hop(WorkerJob* job, WorkerArg /* args */) noexcept -> void
+  {
+    auto self = static_cast<DirectAwaiter*>(job);
+    if (!self->prep()) [[unlikely]] {
+      // failed before the sqe, e.g. no buffer was free, the coroutine resumes with the error from here
+      runJob(&self->mIoJob, {.i32 = self->mIoJob.mResult});
+    }
+  }
+
+  Proactor* mOwner;
+  PromiseBase* mPromise = nullptr;
+};
+
+// the job of an operation which installs a file into the table of the ring it was submitted to
+struct InstallJob : IoJob {
+  InstallJob() noexcept : IoJob(nullptr) { WorkerJob::run = &InstallJob::run; }
+  static auto run(WorkerJob* job, WorkerArg args) noexcept -> void
+  {
+    auto self = static_cast<InstallJob*>(job);
+    if (args.i32 >= 0 && self->mOwner != nullptr) {
+      // counted before the coroutine may move on, see `Proactor::idle()`
+      self->mOwner->adoptDirect();
+    }
+    IoJob::run(job, args);
+  }
+  auto result() noexcept -> std::pair<DirectFd, std::errc>
+  {
+    if (mResult < 0) {
+      return {DirectFd(), std::errc(-mResult)};
+    }
+    return {DirectFd(mResult, mOwner), std::errc(0)};
+  }
+
+  Proactor* mOwner = nullptr;
+};
+
+// accepts into the file table of the calling thread's ring, a regular fd without one
+struct [[nodiscard]] AcceptDirectAwaiter : SocketAwaiter {
+  AcceptDirectAwaiter(int fd) noexcept : SocketAwaiter(fd) {}
+
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+  {
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
+    mIoJob.mOpt = ExeOpt::prefInOne(ExeOpt::High);
+    auto& proactor = Proactor::get();
+    if (proactor.directFiles()) [[likely]] {
+      mIoJob.mOwner = &proactor;
+      proactor.prepAcceptDirect(&mIoJob, mFd);
+    } else {
+      proactor.prepAccept(&mIoJob, mFd, nullptr, nullptr);
+    }
+  }
+  auto await_resume() noexcept -> std::pair<DirectFd, std::errc> { return mIoJob.result(); }
+
+  InstallJob mIoJob;
+};
+
+// IORING_OP_OPENAT into the file table of the calling thread's ring, a regular fd without one
+struct [[nodiscard]] OpenDirectAwaiter {
+  OpenDirectAwaiter(char const* path, int flags, mode_t mode) noexcept : mPath(path), mFlags(flags), mMode(mode) {}
+  auto await_ready() const noexcept -> bool { return false; }
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+  {
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
+    auto& proactor = Proactor::get();
+    if (proactor.directFiles()) [[likely]] {
+      mIoJob.mOwner = &proactor;
+      proactor.prepOpenAtDirect(&mIoJob, mPath, mFlags, mMode);
+    } else {
+      proactor.prepOpenAt(&mIoJob, mPath, mFlags, mMode);
+    }
+  }
+  auto await_resume() noexcept -> std::pair<DirectFd, std::errc> { return mIoJob.result(); }
+
+  InstallJob mIoJob;
+  char const* mPath;
+  int mFlags;
+  mode_t mMode;
+};
+
+// IORING_OP_CLOSE of the slot of a direct descriptor, of the fd of a regular one. Used as
+// `DirectAwaiter<CloseDirectAwaiter, false>`, which submits it on the owner.
+struct [[nodiscard]] CloseDirectAwaiter : SocketAwaiter {
+  CloseDirectAwaiter(int fd, bool direct) noexcept : SocketAwaiter(fd), mIoJob(nullptr), mDirect(direct) {}
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+  {
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
+    if (mDirect) {
+      Proactor::get().prepCloseDirect(&mIoJob, mFd);
+    } else {
+      Proactor::get().prepClose(&mIoJob, mFd);
+    }
+  }
+  auto await_resume() noexcept -> std::errc
+  {
+    if (mIoJob.mResult < 0) {
+      return std::errc(-mIoJob.mResult);
+    } else {
+      return std::errc(0);
+    }
+  }
+
+  IoJob mIoJob;
+  bool mDirect;
+};
+} // namespace coco::sys::detail
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "coco/proactor.hpp"
+#include "coco/sys/fd.hpp"
+
+namespace coco::sys {
+// A file in the registered file table of one thread's ring, a direct descriptor. Operations on it skip the fd lookup of
+// the kernel, but only that ring can submit them: a coroutine which runs on another thread hands its operations to the
+// owner, see `detail::DirectAwaiter`. Without a file table (`Proactor::directFiles()`) it holds a regular fd and
+// `owner()` is nullptr. It must not outlive the runtime whose worker owns it.
+class DirectFd {
+public:
+  DirectFd() noexcept = default;
+  DirectFd(int fd, Proactor* owner) noexcept : mFd(fd), mOwner(owner) {}
+  DirectFd(DirectFd&& other) noexcept : mFd(std::exchange(other.mFd, -1)), mOwner(std::exchange(other.mOwner, nullptr))
+  {
+  }
+  auto operator=(DirectFd&& other) noexcept -> DirectFd&
+  {
+    if (this != &other) {
+      reset();
+      mFd = std::exchange(other.mFd, -1);
+      mOwner = std::exchange(other.mOwner, nullptr);
+    }
+    return *this;
+  }
+  ~DirectFd() noexcept { reset(); }
+
+  // the slot in the owner's table, or the fd
+  auto fd() const noexcept -> int { return mFd; }
+  auto valid() const noexcept -> bool { return mFd >= 0; }
+  auto direct() const noexcept -> bool { return mOwner != nullptr; }
+  auto owner() const noexcept -> Proactor* { return mOwner; }
+  // gives up the descriptor without closing it
+  auto release() noexcept -> std::pair<int, Proactor*>
+  {
+    return {std::exchange(mFd, -1), std::exchange(mOwner, nullptr)};
+  }
+
+private:
+  // a direct descriptor is closed by its owner in the background, from any thread
+  auto reset() noexcept -> void
+  {
+    if (mFd < 0) {
+      return;
+    }
+    if (mOwner != nullptr) {
+      mOwner->closeDirect(mFd);
+    } else {
+      ::close(mFd);
+    }
+    mFd = -1;
+    mOwner = nullptr;
+  }
+
+  int mFd = -1;
+  Proactor* mOwner = nullptr;
+};
+} // namespace coco::sys
\ No newline at end of file
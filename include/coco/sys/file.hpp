@@ -1,5 +1,7 @@
 #pragma once
 
+#include <fcntl.h>
+
 #include "coco/sys/fd.hpp"
 #include "coco/sys/file_awaiters.hpp"
 
@@ -29,5 +31,23 @@ public:
   {
     return detail::WriteAwaiter(mFd, buf, offset);
   }
+  auto read(std::span<std::byte> buf, off_t offset, CancellationToken token) noexcept -> decltype(auto)
+  {
+    return detail::CancelAwaiter<detail::ReadAwaiter>(token, mFd, buf, offset);
+  }
+  auto write(std::span<std::byte const> buf, off_t offset, CancellationToken token) noexcept -> decltype(auto)
+  {
+    return detail::CancelAwaiter<detail::WriteAwaiter>(token, mFd, buf, offset);
+  }
+  // into a buffer from `FixedBuffer::lease()`, the kernel doesn't pin its pages for every read. Reads up to `len`
+  // bytes, the whole buffer by default, and sets `size()` to the bytes read.
+  auto read(FixedBuffer& buf, off_t offset, std::size_t len = -1) noexcept -> decltype(auto)
+  {
+    return detail::ReadFixedAwaiter(mFd, buf, offset, len);
+  }
+  auto write(FixedBuffer const& buf, off_t offset) noexcept -> decltype(auto)
+  {
+    return detail::WriteFixedAwaiter(mFd, buf, offset);
+  }
 };
 } // namespace coco::sys
@@ -20,8 +20,11 @@ struct [[nodiscard]] ReadAwaiter : FileAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto job = &handle.promise();
-    mIoJob.mPending = job;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
     Proactor::get().prepRead(&mIoJob, mFd, mBuf, mOffset);
   }
   auto await_resume() noexcept -> std::pair<std::size_t, std::errc>
@@ -47,8 +50,11 @@ struct [[nodiscard]] WriteAwaiter : FileAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto job = &handle.promise();
-    mIoJob.mPending = job;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
     Proactor::get().prepWrite(&mIoJob, mFd, mBuf, mOffset);
   }
   auto await_resume() noexcept -> std::pair<std::size_t, std::errc>
@@ -64,4 +70,79 @@ struct [[nodiscard]] WriteAwaiter : FileAwaiter {
   off_t mOffset;
   std::span<std::byte const> mBuf;
 };
+// reads up to `len` bytes into a leased buffer with IORING_OP_READ_FIXED and sets its size to the bytes read. Sockets
+// pass offset -1.
+struct [[nodiscard]] ReadFixedAwaiter : FileAwaiter {
+  ReadFixedAwaiter(int fd, FixedBuffer& buf, off_t offset, std::size_t len) noexcept
+      : FileAwaiter(fd), mIoJob(nullptr), mBuf(buf), mOffset(offset), mLen(std::min(len, buf.capacity()))
+  {
+  }
+
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+  {
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
+    auto& proactor = Proactor::get();
+    if (proactor.ownsRegistered(mBuf)) [[likely]] {
+      proactor.prepReadFixed(&mIoJob, mFd, mBuf.whole().first(mLen), mOffset, mBuf.index());
+    } else {
+      proactor.prepRead(&mIoJob, mFd, mBuf.whole().first(mLen), mOffset);
+    }
+  }
+  auto await_resume() noexcept -> std::pair<std::size_t, std::errc>
+  {
+    if (mIoJob.mResult < 0) {
+      mBuf.resize(0);
+      return {0, std::errc(-mIoJob.mResult)};
+    } else {
+      mBuf.resize(mIoJob.mResult);
+      return {std::size_t(mIoJob.mResult), std::errc(0)};
+    }
+  }
+
+  IoJob mIoJob;
+  FixedBuffer& mBuf;
+  off_t mOffset;
+  std::size_t mLen;
+};
+
+// writes `size()` bytes of a leased buffer with IORING_OP_WRITE_FIXED
+struct [[nodiscard]] WriteFixedAwaiter : FileAwaiter {
+  WriteFixedAwaiter(int fd, FixedBuffer const& buf, off_t offset) noexcept
+      : FileAwaiter(fd), mIoJob(nullptr), mBuf(buf), mOffset(offset)
+  {
+  }
+
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+  {
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
+    auto& proactor = Proactor::get();
+    if (proactor.ownsRegistered(mBuf)) [[likely]] {
+      proactor.prepWriteFixed(&mIoJob, mFd, mBuf.span(), mOffset, mBuf.index());
+    } else {
+      proactor.prepWrite(&mIoJob, mFd, mBuf.span(), mOffset);
+    }
+  }
+  auto await_resume() noexcept -> std::pair<std::size_t, std::errc>
+  {
+    if (mIoJob.mResult < 0) {
+      return {0, std::errc(-mIoJob.mResult)};
+    } else {
+      return {std::size_t(mIoJob.mResult), std::errc(0)};
+    }
+  }
+
+  IoJob mIoJob;
+  FixedBuffer const& mBuf;
+  off_t mOffset;
+};
 } // namespace coco::sys::detail
\ No newline at end of file
@@ -1,35 +1,84 @@
 #pragma once
 
+#include "direct.hpp"
 #include "socket.hpp"
 #include "stream.hpp"
 
 namespace coco::sys {
-class TcpListener : private Socket {
+namespace detail {
+// multishot accept, the stream ends with the first error
+class AcceptMultishot : public MultishotState<AcceptMultishot, std::pair<TcpStream, std::errc>> {
 public:
-  TcpListener() noexcept = default;
-  TcpListener(TcpListener&& listener) noexcept = default;
+  using Item = std::pair<TcpStream, std::errc>;
+  using MultishotState::MultishotState;
 
-  static auto bind(SocketAddr const& addr) -> std::pair<TcpListener, std::errc>
+  auto submit(Proactor& proactor) noexcept -> int
   {
-    auto [socket, errc] = Socket::create(addr, Socket::Stream);
-    if (errc != std::errc{0}) {
-      return {TcpListener(), errc};
+    proactor.prepAcceptMt(token(), mFd, nullptr, nullptr);
+    return 0;
+  }
+  auto make(int res, std::uint32_t /* cqeFlags */) noexcept -> Item
+  {
+    if (res < 0) {
+      return {TcpStream(), std::errc(-res)};
     }
-    int opt = 1;
-    errc = socket.setopt(SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-    if (errc != std::errc{0}) {
-      return {TcpListener(), errc};
+    return {TcpStream::from(Socket(res)), std::errc(0)};
+  }
+  auto ends(int res) const noexcept -> bool { return res < 0; }
+  static auto closed() noexcept -> Item { return {TcpStream(), std::errc::operation_canceled}; }
+};
+
+// multishot accept into the file table of the arming thread's ring, regular fds without one
+class AcceptDirectMultishot : public MultishotState<AcceptDirectMultishot, std::pair<DirectStream, std::errc>> {
+public:
+  using Item = std::pair<DirectStream, std::errc>;
+  using MultishotState::MultishotState;
+
+  auto submit(Proactor& proactor) noexcept -> int
+  {
+    if (proactor.directFiles()) [[likely]] {
+      mOwner = &proactor;
+      proactor.prepAcceptMtDirect(token(), mFd);
+    } else {
+      mOwner = nullptr;
+      proactor.prepAcceptMt(token(), mFd, nullptr, nullptr);
     }
-    errc = socket.bind(addr);
-    if (errc != std::errc{0}) {
-      return {TcpListener(), errc};
+    return 0;
+  }
+  // on the owner thread, which counts the descriptor before anyone can drop it
+  auto make(int res, std::uint32_t /* cqeFlags */) noexcept -> Item
+  {
+    if (res < 0) {
+      return {DirectStream(), std::errc(-res)};
     }
-    errc = socket.listen(128);
-    if (errc != std::errc{0}) {
-      return {TcpListener(), errc};
+    if (mOwner != nullptr) {
+      mOwner->adoptDirect();
     }
-    return {TcpListener(std::move(socket)), std::errc{0}};
+    return {DirectStream::from(DirectFd(res, mOwner)), std::errc(0)};
   }
+  auto ends(int res) const noexcept -> bool { return res < 0; }
+  static auto closed() noexcept -> Item { return {DirectStream(), std::errc::operation_canceled}; }
+
+private:
+  Proactor* mOwner = nullptr;
+};
+} // namespace detail
+
+// Connections of a `TcpListener` accepted by a single multishot accept, `operation_canceled` after the stream ended
+// with an error. Destroy it before closing the listener.
+using AcceptStream = MultishotStream<detail::AcceptMultishot>;
+// same as `AcceptStream`, with connections as direct descriptors of the ring which runs the accept
+using AcceptDirectStream = MultishotStream<detail::AcceptDirectMultishot>;
+
+class TcpListener : private Socket {
+public:
+  TcpListener() noexcept = default;
+  TcpListener(TcpListener&& listener) noexcept = default;
+
+  static auto bind(SocketAddr const& addr) -> std::pair<TcpListener, std::errc> { return bind(addr, false); }
+  // one of several listeners on `addr`, e.g. one per core of a `TpcExecutor`. The kernel spreads incoming
+  // connections over them with SO_REUSEPORT, so each one accepts its own share without a shared accept queue.
+  static auto bindShard(SocketAddr const& addr) -> std::pair<TcpListener, std::errc> { return bind(addr, true); }
 
   auto accept() noexcept -> Task<std::pair<TcpStream, std::errc>>
   {
@@ -48,6 +97,36 @@ public:
     }
     co_return {TcpStream::from(std::move(socket)), std::errc{0}};
   }
+  // `operation_canceled` once `token` is stopped
+  auto accept(CancellationToken token) noexcept -> Task<std::pair<TcpStream, std::errc>>
+  {
+    auto [socket, errc] = co_await Socket::accept(token);
+    if (errc != std::errc{0}) {
+      co_return {TcpStream(), errc};
+    }
+    co_return {TcpStream::from(std::move(socket)), std::errc{0}};
+  }
+
+  // every connection with one sqe instead of one per accept. The accept stops while `limit` connections wait for the
+  // consumer, the kernel keeps the following ones in the backlog until it catches up.
+  auto acceptStream(std::size_t limit = 64) -> AcceptStream
+  {
+    return AcceptStream(std::make_shared<detail::AcceptMultishot>(mFd, limit));
+  }
+  // a connection as a direct descriptor in the file table of the calling thread's ring, which spares the kernel the fd
+  // lookup of its every operation. A regular fd if the kernel has no file tables.
+  auto acceptDirect() noexcept -> Task<std::pair<DirectStream, std::errc>>
+  {
+    auto [fd, errc] = co_await detail::AcceptDirectAwaiter(mFd);
+    if (errc != std::errc{0}) {
+      co_return {DirectStream(), errc};
+    }
+    co_return {DirectStream::from(std::move(fd)), std::errc{0}};
+  }
+  auto acceptDirectStream(std::size_t limit = 64) -> AcceptDirectStream
+  {
+    return AcceptDirectStream(std::make_shared<detail::AcceptDirectMultishot>(mFd, limit));
+  }
 
   auto recv(std::span<std::byte> buf) noexcept -> decltype(auto) { return Socket::recv(buf); }
   auto send(std::span<std::byte const> buf) noexcept -> decltype(auto) { return Socket::send(buf); }
@@ -63,5 +142,32 @@ public:
 
 private:
   TcpListener(Socket&& socket) noexcept : Socket(std::move(socket)) {}
+  static auto bind(SocketAddr const& addr, bool reusePort) -> std::pair<TcpListener, std::errc>
+  {
+    auto [socket, errc] = Socket::create(addr, Socket::Stream);
+    if (errc != std::errc{0}) {
+      return {TcpListener(), errc};
+    }
+    int opt = 1;
+    errc = socket.setopt(SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    if (errc != std::errc{0}) {
+      return {TcpListener(), errc};
+    }
+    if (reusePort) {
+      errc = socket.setopt(SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+      if (errc != std::errc{0}) {
+        return {TcpListener(), errc};
+      }
+    }
+    errc = socket.bind(addr);
+    if (errc != std::errc{0}) {
+      return {TcpListener(), errc};
+    }
+    errc = socket.listen(128);
+    if (errc != std::errc{0}) {
+      return {TcpListener(), errc};
+    }
+    return {TcpListener(std::move(socket)), std::errc{0}};
+  }
 };
 } // namespace coco::sys
\ No newline at end of file
@@ -0,0 +1,236 @@
+#pragma once
+
+#include "coco/sys/socket_awaiters.hpp"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace coco::sys::detail {
+// A multishot operation feeding a stream, shared by the ring which runs it and the consumer. Every cqe becomes an
+// item of `Derived::make()` which the consumer takes in order. The operation is armed on the consumer's thread once
+// the consumer drained half of the queue, and cancelled when `mLimit` items wait, so a consumer which falls behind
+// doesn't pile up completions.
+//
+// `Derived` provides
+// - `submit(Proactor&) -> int`, which preps the operation with `token()`, or returns a negative errno
+// - `make(int res, std::uint32_t cqeFlags) -> Item`
+// - `ends(int res) -> bool`, whether the last cqe of the operation with `res` ends the stream
+// - `static closed() -> Item`, what the consumer gets after the end
+template <typename Derived, typename Item>
+class MultishotState : public WorkerJob, public std::enable_shared_from_this<Derived> {
+public:
+  struct [[nodiscard]] NextAwaiter {
+    auto await_ready() const noexcept -> bool { return false; }
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
+    {
+      return mState.wait(handle.promise().getThisJob());
+    }
+    auto await_resume() noexcept -> Item { return mState.pop(); }
+
+    MultishotState& mState;
+  };
+
+  MultishotState(int fd, std::size_t limit) noexcept
+      : WorkerJob(&MultishotState::run, nullptr), mFd(fd), mLimit(std::max(limit, std::size_t(1)))
+  {
+  }
+
+  auto next() noexcept -> NextAwaiter { return {*this}; }
+  // drops the waiting items and cancels the operation, the state lives until its last cqe
+  auto close() noexcept -> void
+  {
+    auto items = std::deque<Item>();
+    std::lock_guard lock(mMt);
+    mClosed = true;
+    mItems.swap(items);
+    if (mArmed && !mStopping) {
+      mStopping = true;
+      mProactor->addCancel(CancelItem::cancelJob(static_cast<WorkerJob*>(this)));
+    }
+  }
+
+protected:
+  auto token() noexcept -> Token { return static_cast<WorkerJob*>(this); }
+
+  int mFd;
+
+private:
+  static auto run(WorkerJob* job, WorkerArg args) noexcept -> void
+  {
+    auto self = static_cast<Derived*>(job);
+    auto& proactor = Proactor::get();
+    auto const flags = proactor.cqeFlags();
+    auto const more = (flags & IORING_CQE_F_MORE) != 0;
+    auto item = self->make(args.i32, flags);
+    auto last = std::shared_ptr<Derived>();
+    WorkerJob* waiter = nullptr;
+    {
+      std::lock_guard lock(self->mMt);
+      if (!more) {
+        // the operation is over, no cancel of it may hit the next one
+        if (self->mStopping) {
+          proactor.dropCancel(job);
+        }
+        self->mArmed = false;
+        last = std::move(self->mInFlight);
+      }
+      auto const stopped = !more && args.i32 == -ECANCELED && self->mStopping;
+      if (!stopped && !self->mClosed) {
+        self->mItems.push_back(std::move(item));
+        self->mDone = !more && self->ends(args.i32);
+        if (more && self->mItems.size() >= self->mLimit && !self->mStopping) {
+          self->mStopping = true;
+          proactor.addCancel(CancelItem::cancelJob(job));
+        }
+      }
+      if (self->mWaiter != nullptr && self->mItems.empty() && !self->mDone && !self->mArmed && !self->mClosed) {
+        // stopped while the consumer caught up, keep it going from here
+        self->arm();
+      }
+      if (self->mWaiter != nullptr && (!self->mItems.empty() || self->mDone)) {
+        waiter = std::exchange(self->mWaiter, nullptr);
+      }
+    }
+    if (waiter == nullptr) {
+      return;
+    }
+    if (proactor.forwarding()) [[unlikely]] {
+      proactor.execute(waiter, ExeOpt::balance());
+    } else if (more) {
+      // cqes with more to come run while the proactor walks the cq ring, the consumer runs after that
+      proactor.execute(waiter, ExeOpt::prefInOne());
+    } else {
+      runJob(waiter, kWorkerArgNull);
+    }
+  }
+
+  // returns whether the consumer has to wait
+  auto wait(WorkerJob* job) noexcept -> bool
+  {
+    std::lock_guard lock(mMt);
+    if (!mArmed && !mDone && !mClosed && mItems.size() <= mLimit / 2) {
+      arm();
+    }
+    if (!mItems.empty() || mDone || mClosed) {
+      return false;
+    }
+    mWaiter = job;
+    return true;
+  }
+  auto pop() noexcept -> Item
+  {
+    std::lock_guard lock(mMt);
+    if (mItems.empty()) {
+      return Derived::closed();
+    }
+    auto item = std::move(mItems.front());
+    mItems.pop_front();
+    return item;
+  }
+  // on the thread whose ring runs the operation, with the lock held
+  auto arm() noexcept -> void
+  {
+    mProactor = &Proactor::get();
+    mStopping = false;
+    if (auto r = static_cast<Derived*>(this)->submit(*mProactor); r < 0) [[unlikely]] {
+      mItems.push_back(static_cast<Derived*>(this)->make(r, 0));
+      return;
+    }
+    mArmed = true;
+    mInFlight = this->shared_from_this();
+  }
+
+  std::mutex mMt;
+  std::deque<Item> mItems;
+  WorkerJob* mWaiter = nullptr;
+  Proactor* mProactor = nullptr;
+  std::shared_ptr<Derived> mInFlight; // keeps the state alive until the last cqe
+  std::size_t mLimit;
+  bool mArmed = false;
+  bool mStopping = false; // a cancel of the operation is queued
+  bool mDone = false;
+  bool mClosed = false;
+};
+
+// multishot recv with buffers of the arming thread's `BufferRing`, one plain recv at a time without a registered ring
+class RecvMultishot : public MultishotState<RecvMultishot, std::pair<ProvidedBuffer, std::errc>> {
+public:
+  using Item = std::pair<ProvidedBuffer, std::errc>;
+  using MultishotState::MultishotState;
+
+  auto submit(Proactor& proactor) noexcept -> int
+  {
+    mRing = proactor.bufferRing().shared_from_this();
+    if (mRing->registered()) [[likely]] {
+      proactor.prepRecvMultishot(token(), mFd, mRing->groupId());
+      return 0;
+    }
+    mLeased = mRing->lease();
+    if (!mLeased) [[unlikely]] {
+      return -ENOBUFS;
+    }
+    proactor.prepRecv(token(), mFd, {mLeased.data(), mRing->bufferSize()});
+    return 0;
+  }
+  auto make(int res, std::uint32_t cqeFlags) noexcept -> Item
+  {
+    if (res < 0) {
+      mLeased.release();
+      return {ProvidedBuffer(), std::errc(-res)};
+    }
+    if (mLeased) {
+      mRing->fill(mLeased, res);
+      return {res > 0 ? std::move(mLeased) : ProvidedBuffer(), std::errc(0)};
+    }
+    return {mRing->take(cqeFlags, res), std::errc(0)};
+  }
+  // running out of buffers only pauses the stream
+  auto ends(int res) const noexcept -> bool { return res == 0 || (res < 0 && res != -ENOBUFS); }
+  static auto closed() noexcept -> Item { return {ProvidedBuffer(), std::errc(0)}; }
+
+private:
+  std::shared_ptr<BufferRing> mRing;
+  ProvidedBuffer mLeased;
+};
+} // namespace coco::sys::detail
+
+namespace coco::sys {
+// The items of a multishot operation in the order the kernel posted them, see `TcpStream::recvMultishot()` and
+// `TcpListener::acceptStream()`. Destroying it cancels the operation.
+template <typename State>
+class MultishotStream {
+public:
+  MultishotStream() noexcept = default;
+  explicit MultishotStream(std::shared_ptr<State> state) noexcept : mState(std::move(state)) {}
+  MultishotStream(MultishotStream&& other) noexcept = default;
+  auto operator=(MultishotStream&& other) noexcept -> MultishotStream&
+  {
+    if (this != &other) {
+      reset();
+      mState = std::move(other.mState);
+    }
+    return *this;
+  }
+  ~MultishotStream() noexcept { reset(); }
+
+  auto next() noexcept -> decltype(auto) { return mState->next(); }
+
+private:
+  auto reset() noexcept -> void
+  {
+    if (mState != nullptr) {
+      mState->close();
+      mState.reset();
+    }
+  }
+
+  std::shared_ptr<State> mState;
+};
+
+// What a connection receives as buffers of the worker's `BufferRing`. `next()` gives an empty buffer without error once
+// the peer shut down, and `no_buffer_space` if the ring ran dry, the stream goes on when awaited again. Destroy it
+// before closing the connection.
+using RecvStream = MultishotStream<detail::RecvMultishot>;
+} // namespace coco::sys
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <sys/un.h>
 
 #include "coco/sys/fd.hpp"
+#include "coco/sys/file_awaiters.hpp"
 #include "coco/sys/socket_addr.hpp"
 #include "coco/sys/socket_awaiters.hpp"
 
@@ -90,6 +91,20 @@ public:
   {
     return detail::SendTimeoutAwaiter(mFd, buf, duration);
   }
+  auto recv(std::span<std::byte> buf, CancellationToken token) noexcept -> decltype(auto)
+  {
+    return detail::CancelAwaiter<detail::RecvAwaiter>(token, mFd, buf);
+  }
+  auto send(std::span<std::byte const> buf, CancellationToken token) noexcept -> decltype(auto)
+  {
+    return detail::CancelAwaiter<detail::SendAwaiter>(token, mFd, buf);
+  }
+  // a buffer from `FixedBuffer::lease()` with IORING_OP_READ_FIXED, `size()` is set to the bytes received
+  auto recv(FixedBuffer& buf) noexcept -> decltype(auto) { return detail::ReadFixedAwaiter(mFd, buf, -1, buf.capacity()); }
+  // into a buffer of the worker's `BufferRing` which the kernel picks once data arrived
+  auto recv() noexcept -> decltype(auto) { return detail::RecvSelectAwaiter(mFd); }
+  // `size()` bytes of a leased buffer with zero copy IORING_OP_SEND_ZC, resumes once the buffer is free again
+  auto send(FixedBuffer const& buf) noexcept -> decltype(auto) { return detail::SendZcAwaiter(mFd, buf); }
   auto sendTo(std::span<std::byte const> buf, SocketAddr const& addr, int flags = 0) noexcept -> decltype(auto)
   {
     return detail::SendToAwaiter(mFd, buf, addr);
@@ -104,12 +119,21 @@ public:
   }
   auto accept(Duration duration) noexcept -> decltype(auto) { return detail::AcceptTimeoutAwaiter(mFd, duration); }
   auto accept(int flags = 0) noexcept -> decltype(auto) { return detail::AcceptAwaiter(mFd); }
+  auto accept(CancellationToken token) noexcept -> decltype(auto)
+  {
+    return detail::CancelAwaiter<detail::AcceptAwaiter>(token, mFd);
+  }
   auto addAcceptMultishot(WorkerJob* job, int flags = 0)
   {
     return Proactor::get().prepAcceptMt(job, mFd, nullptr, nullptr, flags);
   }
   auto connect(SocketAddr addr) noexcept -> decltype(auto) { return detail::ConnectAwaiter(mFd, addr); }
-  auto close() noexcept -> decltype(auto) { return detail::CloseAwaiter(mFd); }
+  auto connect(SocketAddr addr, CancellationToken token) noexcept -> decltype(auto)
+  {
+    return detail::CancelAwaiter<detail::ConnectAwaiter>(token, mFd, addr);
+  }
+  // the descriptor is released right away, so that the destructor doesn't close its number again once reused
+  auto close() noexcept -> decltype(auto) { return detail::CloseAwaiter(std::exchange(mFd, -1)); }
   auto setopt(int level, int optname, void const* optval, socklen_t optlen) noexcept -> std::errc
   {
     if (::setsockopt(mFd, level, optname, optval, optlen) == -1) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "coco/cancel.hpp"
 #include "coco/proactor.hpp"
 #include "coco/sys/socket_addr.hpp"
 #include "coco/task.hpp"
@@ -23,9 +24,12 @@ struct [[nodiscard]] IoJob : WorkerJob {
   {
     auto self = static_cast<IoJob*>(job);
     self->mResult = args.i32;
+    trace(TraceKind::Io, self->mPending, std::uint64_t(std::uint32_t(args.i32)));
     auto* selfJob = self->mPending->getThisJob();
     if (self->mOpt.mPri == ExeOpt::High) [[unlikely]] {
       Proactor::get().execute(selfJob, self->mOpt);
+    } else if (Proactor::get().forwarding()) [[unlikely]] {
+      Proactor::get().execute(selfJob, ExeOpt::balance());
     } else {
       selfJob->run(selfJob, args);
     }
@@ -35,6 +39,78 @@ struct [[nodiscard]] IoJob : WorkerJob {
   PromiseBase* mPending;
 };
 
+// `Awaiter` with a `CancellationToken`. The operation is registered with the token while it is in flight, a stop
+// cancels it on the ring which submitted it and the awaiter sees `operation_canceled` like any other error. If the
+// stop came first the operation isn't submitted.
+template <typename Awaiter>
+struct [[nodiscard]] CancelAwaiter : Awaiter, coco::detail::StopNode {
+  template <typename... Args>
+  CancelAwaiter(CancellationToken token, Args&&... args) noexcept
+      : Awaiter(std::forward<Args>(args)...), mToken(token)
+  {
+    mCancel = &cancel;
+  }
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
+  {
+    return suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> bool
+  {
+    mProactor = &Proactor::get();
+    if (!mToken.attach(this)) [[unlikely]] {
+      this->mIoJob.mResult = -ECANCELED;
+      return false;
+    }
+    Awaiter::suspend(promise);
+    return true;
+  }
+  auto await_resume() noexcept -> decltype(auto)
+  {
+    if (mToken.detach(this)) [[unlikely]] {
+      // the operation may have completed before the cancel was submitted
+      mProactor->dropCancel(&this->mIoJob);
+    }
+    return Awaiter::await_resume();
+  }
+
+  // called by `StopSource::requestStop()` on any thread, the owner of the ring submits the cancel
+  static auto cancel(coco::detail::StopNode* node) noexcept -> void
+  {
+    auto self = static_cast<CancelAwaiter*>(node);
+    self->mProactor->addCancel(CancelItem::cancelJob(&self->mIoJob));
+  }
+
+  CancellationToken mToken;
+  Proactor* mProactor = nullptr;
+};
+
+// IORING_OP_TIMEOUT as a plain sleep, which unlike the timers of `Proactor::addTimer()` can be cancelled
+struct [[nodiscard]] TimeoutAwaiter {
+  TimeoutAwaiter(Duration duration) noexcept : mIoJob(nullptr) { coco::convertTime(duration, mSpec); }
+  auto await_ready() const noexcept -> bool { return false; }
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+  {
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
+    Proactor::get().prepTimeout(&mIoJob, &mSpec);
+  }
+  auto await_resume() noexcept -> std::errc
+  {
+    if (mIoJob.mResult < 0 && mIoJob.mResult != -ETIME) {
+      return std::errc(-mIoJob.mResult);
+    }
+    return std::errc(0);
+  }
+
+  IoJob mIoJob;
+  __kernel_timespec mSpec;
+};
+
 struct SocketAwaiter {
   SocketAwaiter(int fd) noexcept : mFd(fd) {}
   auto await_ready() const noexcept -> bool { return false; }
@@ -46,8 +122,11 @@ struct [[nodiscard]] CloseAwaiter : SocketAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto promise = &handle.promise();
-    mIoJob.mPending = promise;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
     Proactor::get().prepClose(&mIoJob, mFd);
   }
   auto await_resume() noexcept -> std::errc
@@ -67,8 +146,11 @@ struct [[nodiscard]] RecvAwaiter : SocketAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto promise = &handle.promise();
-    mIoJob.mPending = promise;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
 
     Proactor::get().prepRecv(&mIoJob, mFd, mBuf);
   }
@@ -90,8 +172,11 @@ struct [[nodiscard]] SendAwaiter : SocketAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto promise = &handle.promise();
-    mIoJob.mPending = promise;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
     Proactor::get().prepSend(&mIoJob, mFd, mBuf);
   }
   auto await_resume() noexcept -> std::pair<std::size_t, std::errc>
@@ -107,6 +192,109 @@ struct [[nodiscard]] SendAwaiter : SocketAwaiter {
   std::span<std::byte const> mBuf;
 };
 
+// sends `size()` bytes of a leased buffer with IORING_OP_SEND_ZC. The kernel posts the result first and a
+// notification once it let go of the buffer, the task resumes after the latter so that the buffer can be reused.
+struct [[nodiscard]] SendZcAwaiter : SocketAwaiter {
+  struct ZcJob : IoJob {
+    ZcJob() noexcept : IoJob(nullptr) { WorkerJob::run = &ZcJob::run; }
+    static auto run(WorkerJob* job, WorkerArg args) noexcept -> void
+    {
+      auto self = static_cast<ZcJob*>(job);
+      if (Proactor::get().pending(job)) {
+        // the result, the notification follows
+        self->mSent = args.i32;
+        self->mHasSent = true;
+        return;
+      }
+      IoJob::run(job, {.i32 = self->mHasSent ? self->mSent : args.i32});
+    }
+    int mSent = 0;
+    bool mHasSent = false;
+  };
+
+  SendZcAwaiter(int fd, FixedBuffer const& buf) noexcept : SocketAwaiter(fd), mBuf(buf) {}
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+  {
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
+    auto& proactor = Proactor::get();
+    if (proactor.ownsRegistered(mBuf)) [[likely]] {
+      proactor.prepSendZcFixed(&mIoJob, mFd, mBuf.span(), mBuf.index());
+    } else {
+      proactor.prepSend(&mIoJob, mFd, mBuf.span());
+    }
+  }
+  auto await_resume() noexcept -> std::pair<std::size_t, std::errc>
+  {
+    if (mIoJob.mResult < 0) {
+      return {0, std::errc(-mIoJob.mResult)};
+    } else {
+      return {std::size_t(mIoJob.mResult), std::errc(0)};
+    }
+  }
+
+  ZcJob mIoJob;
+  FixedBuffer const& mBuf;
+};
+
+// receives into a buffer of the calling thread's `BufferRing`, which the kernel picks only once data arrived. Without a
+// registered ring a buffer is leased up front and the recv goes the plain path.
+struct [[nodiscard]] RecvSelectAwaiter : SocketAwaiter {
+  struct SelectJob : IoJob {
+    SelectJob() noexcept : IoJob(nullptr) { WorkerJob::run = &SelectJob::run; }
+    static auto run(WorkerJob* job, WorkerArg args) noexcept -> void
+    {
+      static_cast<SelectJob*>(job)->mFlags = Proactor::get().cqeFlags();
+      IoJob::run(job, args);
+    }
+    std::uint32_t mFlags = 0;
+  };
+
+  RecvSelectAwaiter(int fd) noexcept : SocketAwaiter(fd) {}
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
+  {
+    return suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> bool
+  {
+    mIoJob.mPending = &promise;
+    auto& proactor = Proactor::get();
+    mRing = proactor.bufferRing().shared_from_this();
+    if (mRing->registered()) [[likely]] {
+      proactor.prepRecvSelect(&mIoJob, mFd, mRing->groupId());
+      return true;
+    }
+    mBuf = mRing->lease();
+    if (!mBuf) [[unlikely]] {
+      mIoJob.mResult = -ENOBUFS;
+      return false;
+    }
+    proactor.prepRecv(&mIoJob, mFd, {mBuf.data(), mRing->bufferSize()});
+    return true;
+  }
+  // an empty buffer without error once the peer shut down
+  auto await_resume() noexcept -> std::pair<ProvidedBuffer, std::errc>
+  {
+    if (mIoJob.mResult < 0) {
+      return {ProvidedBuffer(), std::errc(-mIoJob.mResult)};
+    }
+    if (mBuf) {
+      mRing->fill(mBuf, mIoJob.mResult);
+      return {mIoJob.mResult > 0 ? std::move(mBuf) : ProvidedBuffer(), std::errc(0)};
+    }
+    return {mRing->take(mIoJob.mFlags, mIoJob.mResult), std::errc(0)};
+  }
+
+  SelectJob mIoJob;
+  std::shared_ptr<BufferRing> mRing;
+  ProvidedBuffer mBuf;
+};
+
 struct [[nodiscard]] SendMsgAwaiter : SocketAwaiter {
   SendMsgAwaiter(int fd, void* name, socklen_t namelen, ::iovec* iov, std::size_t iovlen) noexcept
       : SocketAwaiter(fd), mIoJob(nullptr), mMsg{name, namelen, iov, iovlen, nullptr, 0, 0}
@@ -115,8 +303,11 @@ struct [[nodiscard]] SendMsgAwaiter : SocketAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto promise = &handle.promise();
-    mIoJob.mPending = promise;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
 
     Proactor::get().prepSendMsg(&mIoJob, mFd, &mMsg);
   }
@@ -141,8 +332,11 @@ struct [[nodiscard]] RecvMsgAwaiter : SocketAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto promise = &handle.promise();
-    mIoJob.mPending = promise;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
 
     Proactor::get().prepRecvMsg(&mIoJob, mFd, &mMsg);
   }
@@ -199,8 +393,11 @@ struct [[nodiscard]] ConnectAwaiter : SocketAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto job = &handle.promise();
-    mIoJob.mPending = job;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
     if (mAddr.isIpv6()) {
       sockaddr_in6 v6;
       mAddr.setSys(v6);
@@ -229,8 +426,11 @@ struct [[nodiscard]] AcceptAwaiter : SocketAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto promise = &handle.promise();
-    mIoJob.mPending = promise;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
     mIoJob.mOpt = ExeOpt::prefInOne(ExeOpt::High);
     Proactor::get().prepAccept(&mIoJob, mFd, nullptr, nullptr);
   }
@@ -255,8 +455,11 @@ struct [[nodiscard]] RecvTimeoutAwaiter : RecvAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto promise = &handle.promise();
-    mIoJob.mPending = promise;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
 
     mProactor = &Proactor::get();
     mProactor->prepRecv(&mIoJob, mFd, mBuf);
@@ -289,8 +492,11 @@ struct [[nodiscard]] SendTimeoutAwaiter : SendAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto promise = &handle.promise();
-    mIoJob.mPending = promise;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
 
     mProactor = &Proactor::get();
     mProactor->prepSend(&mIoJob, mFd, mBuf);
@@ -321,8 +527,11 @@ struct [[nodiscard]] AcceptTimeoutAwaiter : AcceptAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto promise = &handle.promise();
-    mIoJob.mPending = promise;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
 
     mProactor = &Proactor::get();
     mProactor->prepAccept(&mIoJob, mFd, nullptr, nullptr);
@@ -357,8 +566,11 @@ struct [[nodiscard]] ConnectTimeoutAwaiter : ConnectAwaiter {
   template <typename Promise>
   auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
   {
-    auto job = &handle.promise();
-    mIoJob.mPending = job;
+    suspend(handle.promise());
+  }
+  auto suspend(PromiseBase& promise) noexcept -> void
+  {
+    mIoJob.mPending = &promise;
 
     mProactor = &Proactor::get();
     if (mAddr.isIpv4()) {
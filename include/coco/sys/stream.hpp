@@ -1,5 +1,6 @@
 #pragma once
 
+#include "coco/sys/multishot.hpp"
 #include "coco/sys/socket.hpp"
 #include "coco/task.hpp"
 
@@ -47,6 +48,24 @@ public:
   {
     return Socket::recv(buf, timeout);
   }
+  auto recv(std::span<std::byte> buf, CancellationToken token) noexcept -> decltype(auto)
+  {
+    return Socket::recv(buf, token);
+  }
+  auto send(std::span<std::byte const> buf, CancellationToken token) noexcept -> decltype(auto)
+  {
+    return Socket::send(buf, token);
+  }
+  auto recv(FixedBuffer& buf) noexcept -> decltype(auto) { return Socket::recv(buf); }
+  auto send(FixedBuffer const& buf) noexcept -> decltype(auto) { return Socket::send(buf); }
+  // `std::pair<ProvidedBuffer, std::errc>`, the kernel takes a buffer from the worker's `BufferRing` only once data
+  // arrived, so an idle connection holds none
+  auto recv() noexcept -> decltype(auto) { return Socket::recv(); }
+  // everything the connection receives, with a single multishot recv. The recv pauses while `limit` buffers wait.
+  auto recvMultishot(std::size_t limit = 16) -> RecvStream
+  {
+    return RecvStream(std::make_shared<detail::RecvMultishot>(mFd, limit));
+  }
   auto close() noexcept -> decltype(auto) { return Socket::close(); }
 
 private:
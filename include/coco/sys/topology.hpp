@@ -0,0 +1,25 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace coco::sys {
+// NUMA nodes and the cpus of each node this process may run on, read from sysfs. Machines without NUMA
+// information are reported as a single node.
+struct CpuTopology {
+  static auto detect() -> CpuTopology;
+
+  auto cpuCount() const noexcept -> std::size_t;
+  // index into `mNodes`, -1 if `cpu` is not in any node
+  auto nodeOf(int cpu) const noexcept -> int;
+
+  std::vector<std::vector<int>> mNodes;
+};
+
+// parses the kernel's cpu list format, e.g. "0-3,8,10-11"
+auto parseCpuList(std::string_view list) -> std::vector<int>;
+// pins the calling thread to `cpus`
+auto setThreadAffinity(std::span<int const> cpus) noexcept -> std::errc;
+} // namespace coco::sys
\ No newline at end of file
@@ -1,33 +1,90 @@
 #pragma once
 
 #include "coco/proactor.hpp"
+#include "coco/trace.hpp"
+#include "coco/util/frame_pool.hpp"
 
 #include <coroutine>
 #include <memory>
 #include <optional>
+#include <system_error>
 #include <utility>
 #include <variant>
 
 namespace coco {
+struct Deadline {
+  Instant mInstant;
+  // complete the task with `std::errc::timed_out` instead of starting it once the deadline passed
+  bool mShed = false;
+};
+
+#ifdef COCO_TRACE
+namespace detail {
+// what `PromiseBase::await_transform()` hands back, it only forwards to the real awaiter
+template <typename Awaiter>
+struct TracedAwaiter {
+  auto await_ready() -> bool { return mAwaiter.await_ready(); }
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) -> decltype(auto)
+  {
+    return mAwaiter.await_suspend(handle);
+  }
+  auto await_resume() -> decltype(auto) { return mAwaiter.await_resume(); }
+
+  Awaiter mAwaiter;
+};
+} // namespace detail
+#endif
+
+struct PromiseBase;
+namespace detail {
+// continuation of a task which is collected instead of awaited, e.g. by a `TaskGroup`. Runs on the thread which
+// completes the task, right before the task's frame is destroyed, so the task can't be joined.
+struct CompletionJob : WorkerJob {
+  using CompleteFn = void (*)(CompletionJob* self, PromiseBase& done) noexcept;
+  explicit CompletionJob(CompleteFn fn) noexcept : WorkerJob(&tag, nullptr), complete(fn) {}
+  // marks the job for `FinalAwaiter`, never run through the executor
+  static auto tag(WorkerJob*, WorkerArg) noexcept -> void { assert(false && "completion job must not be executed"); }
+
+  CompleteFn complete;
+};
+} // namespace detail
+
 struct PromiseBase {
   struct CoroJob : WorkerJob {
-    CoroJob(PromiseBase* promise, WorkerJob::WorkerFn run) noexcept : promise(promise), WorkerJob(run, nullptr) {}
+    CoroJob(PromiseBase* promise, WorkerJob::WorkerFn run) noexcept : promise(promise), WorkerJob(run, nullptr)
+    {
+      prio = detail::tCurrentPriority;
+      trace(TraceKind::Spawn, promise);
+    }
     static auto run(WorkerJob* job, WorkerArg) noexcept -> void
     {
       auto coroJob = static_cast<CoroJob*>(job);
-      coroJob->promise->mThisHandle.resume();
+      // restored afterwards, so that the class doesn't stick to the thread once the task suspends
+      auto const outer = std::exchange(detail::tCurrentPriority, coroJob->prio);
+      coroJob->shed = false; // a started task runs to completion
+      auto const promise = coroJob->promise;
+      trace(TraceKind::Run, promise);
+      promise->mThisHandle.resume();
+      // the frame may be gone or running elsewhere by now, only its address is recorded
+      trace(TraceKind::Suspend, promise);
+      detail::tCurrentPriority = outer;
     }
     PromiseBase* promise;
+    Instant deadline{}; // valid if `hasDeadline`
   };
 
   struct FinalAwaiter {
     auto await_ready() const noexcept -> bool { return false; }
     template <typename Promise>
-    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> std::coroutine_handle<>
     {
       assert(handle.done() && "handle should done here");
-      auto& promise = handle.promise();
-
+      return complete(handle.promise());
+    }
+    static auto complete(PromiseBase& promise) noexcept -> std::coroutine_handle<>
+    {
+      trace(TraceKind::Complete, &promise);
       auto next = promise.mNextJob.exchange(nullptr);
       if (next == nullptr) {
         if (promise.getState() != nullptr) [[unlikely]] {
@@ -40,13 +97,44 @@ struct PromiseBase {
           promise.getState()->notify_one();
         }
         promise.mThisHandle.destroy();
+      } else if (next->run == &detail::CompletionJob::tag) {
+        auto completion = static_cast<detail::CompletionJob*>(next);
+        completion->complete(completion, promise);
+        promise.mThisHandle.destroy();
       } else if (next != &detail::kEmptyJob) {
+        if (promise.mResumeInline) {
+          // awaited directly by `co_await task`, continue the parent on this thread and in its class
+          auto parent = static_cast<CoroJob*>(next)->promise;
+          detail::tCurrentPriority = parent->priority();
+          return parent->mThisHandle;
+        }
         Proactor::get().execute(next, ExeOpt::prefInOne());
       }
+      return std::noop_coroutine();
     }
     auto await_resume() noexcept -> void {}
   };
 
+#ifdef COCO_FRAME_POOL
+  static auto operator new(std::size_t size) -> void* { return util::FramePool::allocate(size); }
+  static auto operator delete(void* ptr, std::size_t size) noexcept -> void { util::FramePool::deallocate(ptr, size); }
+#endif
+
+#ifdef COCO_TRACE
+  // records what the task waits on, then awaits it as usual
+  template <typename Awaitable>
+  auto await_transform(Awaitable&& awaitable)
+  {
+    trace(TraceKind::Await, this, 0, traceName<std::remove_cvref_t<Awaitable>>());
+    if constexpr (requires { std::forward<Awaitable>(awaitable).operator co_await(); }) {
+      using Awaiter = decltype(std::forward<Awaitable>(awaitable).operator co_await());
+      return detail::TracedAwaiter<Awaiter>{std::forward<Awaitable>(awaitable).operator co_await()};
+    } else {
+      return detail::TracedAwaiter<Awaitable&>{awaitable};
+    }
+  }
+#endif
+
   auto initial_suspend() noexcept -> std::suspend_always { return {}; }
   auto final_suspend() noexcept -> FinalAwaiter { return {}; }
   auto unhandled_exception() noexcept -> void { mExceptionPtr = std::current_exception(); }
@@ -54,6 +142,25 @@ struct PromiseBase {
   auto setCoHandle(std::coroutine_handle<> handle) noexcept -> void { mThisHandle = handle; }
   auto getThisJob() noexcept -> WorkerJob* { return &mThisJob; }
 
+  auto priority() const noexcept -> Priority { return mThisJob.prio; }
+  auto setPriority(Priority prio) noexcept -> void { mThisJob.prio = prio; }
+  auto setDeadline(Deadline deadline) noexcept -> void
+  {
+    mThisJob.hasDeadline = true;
+    mThisJob.shed = deadline.mShed;
+    mThisJob.deadline = deadline.mInstant;
+  }
+  // finish a task which never ran as if it threw `std::errc::timed_out`, its frame is left unstarted
+  auto shed() noexcept -> void
+  {
+    assert(!mThisHandle.done() && "a shed task must not have run");
+    // shared by all shed tasks, so that shedding under overload doesn't allocate
+    static auto const kTimedOut =
+        std::make_exception_ptr(std::system_error(std::make_error_code(std::errc::timed_out)));
+    mExceptionPtr = kTimedOut;
+    FinalAwaiter::complete(*this);
+  }
+
   auto getState() noexcept -> std::atomic<JobState>* { return mThisJob.state; }
   auto setState(std::atomic<JobState>* state) noexcept -> void { mThisJob.state = state; }
   auto setDetach() noexcept -> void
@@ -63,6 +170,7 @@ struct PromiseBase {
   }
 
   auto setNextJob(WorkerJob* next) noexcept -> void { mNextJob = next; }
+  auto setResumeInline() noexcept -> void { mResumeInline = true; }
   auto getNextJob() noexcept -> std::atomic<WorkerJob*>& { return mNextJob; }
 
   auto setExeception(std::exception_ptr exceptionPtr) noexcept -> void { mExceptionPtr = exceptionPtr; }
@@ -73,6 +181,7 @@ struct PromiseBase {
   std::coroutine_handle<> mThisHandle;
   std::atomic<WorkerJob*> mNextJob{nullptr};
   std::exception_ptr mExceptionPtr;
+  bool mResumeInline = false;
 };
 
 template <typename T>
@@ -157,15 +266,40 @@ public:
   auto promise() && -> promise_type&& { return std::move(mHandle.promise()); }
 
   auto take() noexcept -> coroutine_handle_type { return std::exchange(mHandle, nullptr); }
+  // a task starts in the class of the coroutine which created it, `spawn(work().withPriority(...))` overrides that
+  auto withPriority(Priority prio) && noexcept -> Task&&
+  {
+    mHandle.promise().setPriority(prio);
+    return std::move(*this);
+  }
+  // once queued, the task is picked ahead of the ones without a deadline in its class, earliest deadline first
+  auto withDeadline(Deadline deadline) && noexcept -> Task&&
+  {
+    mHandle.promise().setDeadline(deadline);
+    return std::move(*this);
+  }
 
   struct AwaiterBase {
     auto await_ready() const noexcept -> bool { return false; }
     template <typename Promise>
-    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
     {
-      mHandle.promise().setNextJob(handle.promise().getThisJob());
-      mHandle.promise().setState(handle.promise().getState());
-      Proactor::get().execute(mHandle.promise().getThisJob(), ExeOpt::prefInOne());
+      // Run the child right here instead of going through the executor. If it finishes before its first real
+      // suspension the FinalAwaiter takes the `kEmptyJob` and we continue without suspending at all, otherwise the
+      // child resumes us from its FinalAwaiter on whatever thread it completes. This keeps the stack bounded by
+      // the nesting depth even when the compiler doesn't turn symmetric transfer into a tail call.
+      // an awaited child works on behalf of its parent and is scheduled in the parent's class, on its core
+      auto& promise = mHandle.promise();
+      promise.setPriority(handle.promise().priority());
+      promise.getThisJob()->home = handle.promise().getThisJob()->home;
+      promise.setNextJob(&detail::kEmptyJob);
+      promise.setState(handle.promise().getState());
+      promise.setResumeInline();
+      mHandle.resume();
+      // the child may have run other coroutines on this thread, go on in our own class
+      detail::tCurrentPriority = handle.promise().priority();
+      WorkerJob* expected = &detail::kEmptyJob;
+      return promise.getNextJob().compare_exchange_strong(expected, handle.promise().getThisJob());
     }
     coroutine_handle_type mHandle;
   };
@@ -224,8 +358,20 @@ struct [[nodiscard]] Yield {
   constexpr auto await_suspend(std::coroutine_handle<Promise> handle) noexcept
   {
     // suspend then reshcedule
-    Proactor::get().execute(handle.promise().getThisJob());
+    Proactor::get().execute(handle.promise().getThisJob(), ExeOpt::yield());
   }
   constexpr auto await_resume() const noexcept -> void {}
 };
+
+// yields only if the current worker has used up its budget, so that io completions and timers are polled
+// before this task continues. Cheap enough for the inner loop of a long running task.
+struct [[nodiscard]] Checkpoint {
+  auto await_ready() const noexcept -> bool { return !Proactor::get().overBudget(); }
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+  {
+    Proactor::get().execute(handle.promise().getThisJob(), ExeOpt::yield());
+  }
+  auto await_resume() const noexcept -> void {}
+};
 } // namespace coco
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "coco/cancel.hpp"
+#include "coco/task.hpp"
+
+#include <exception>
+
+namespace coco {
+// A nursery for child tasks: `spawn()` starts a child, `co_await group.join()` suspends until every child finished.
+// All children count down one shared counter and the last one wakes the parent, so the parent is resumed once no
+// matter how many children there are. A child needs nothing besides its coroutine frame, which is freed as soon as
+// the child is done.
+// The first exception thrown by a child stops the group: children which didn't start yet are dropped without running
+// and the exception is rethrown from `join()`. Running children finish on their own, long ones can poll
+// `stopRequested()` or pass `token()` to their io, which is then cancelled by the stop. The group must be joined
+// before it goes out of scope, and only once.
+class TaskGroup {
+public:
+  TaskGroup() noexcept = default;
+  TaskGroup(TaskGroup const&) = delete;
+  auto operator=(TaskGroup const&) -> TaskGroup& = delete;
+  ~TaskGroup() noexcept
+  {
+    assert(mPending.load(std::memory_order_acquire) <= 1 && "looks like you forget to join the TaskGroup");
+  }
+
+  auto spawn(Task<> task) noexcept -> void
+  {
+    assert(!mJoined && "spawn into a joined TaskGroup");
+    if (stopRequested()) {
+      return; // dropped like the queued children
+    }
+    mPending.fetch_add(1, std::memory_order_relaxed);
+    auto& promise = task.promise();
+    promise.setNextJob(&mCompletion);
+    auto job = promise.getThisJob();
+    job->run = &start;
+    Proactor::get().execute(job, ExeOpt::balance());
+    [[maybe_unused]] auto handle = task.take();
+  }
+
+  // children which didn't start yet are dropped, the running ones can see it in `stopRequested()` and their io
+  // with `token()` is cancelled
+  auto requestStop() noexcept -> void { mStop.requestStop(); }
+  auto stopRequested() const noexcept -> bool { return mStop.stopRequested(); }
+  auto token() noexcept -> CancellationToken { return mStop.token(); }
+
+  struct [[nodiscard]] JoinAwaiter {
+    auto await_ready() const noexcept -> bool { return false; }
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
+    {
+      mGroup.mJoined = true;
+      mGroup.mWaiter = handle.promise().getThisJob();
+      // drop the reference the group holds for its parent, if the children are already done there is no wait
+      return mGroup.mPending.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+    auto await_resume() const -> void
+    {
+      if (mGroup.mError != nullptr) [[unlikely]] {
+        std::rethrow_exception(mGroup.mError);
+      }
+    }
+
+    TaskGroup& mGroup;
+  };
+  [[nodiscard]] auto join() noexcept -> JoinAwaiter { return JoinAwaiter{*this}; }
+
+private:
+  struct Completion : detail::CompletionJob {
+    explicit Completion(TaskGroup* group) noexcept : CompletionJob(&TaskGroup::childDone), mGroup(group) {}
+    TaskGroup* mGroup;
+  };
+
+  // first run of a child, which doesn't start any more once the group is stopped
+  static auto start(WorkerJob* job, WorkerArg arg) noexcept -> void
+  {
+    auto coroJob = static_cast<PromiseBase::CoroJob*>(job);
+    auto promise = coroJob->promise;
+    auto group = static_cast<Completion*>(promise->getNextJob().load(std::memory_order_relaxed))->mGroup;
+    if (group->stopRequested()) [[unlikely]] {
+      promise->mThisHandle.destroy();
+      group->release();
+      return;
+    }
+    job->run = &PromiseBase::CoroJob::run;
+    PromiseBase::CoroJob::run(job, arg);
+  }
+  static auto childDone(detail::CompletionJob* job, PromiseBase& done) noexcept -> void
+  {
+    auto group = static_cast<Completion*>(job)->mGroup;
+    if (done.hasException()) [[unlikely]] {
+      if (!group->mFailed.exchange(true, std::memory_order_relaxed)) {
+        group->mError = done.currentException();
+        group->requestStop();
+      }
+    }
+    group->release();
+  }
+  auto release() noexcept -> void
+  {
+    if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      Proactor::get().execute(mWaiter, ExeOpt::prefInOne());
+    }
+  }
+
+  Completion mCompletion{this};
+  // running children, plus one for the parent until it joins
+  std::atomic_size_t mPending{1};
+  WorkerJob* mWaiter = nullptr;
+  StopSource mStop;
+  std::atomic_bool mFailed{false};
+  std::exception_ptr mError;
+  bool mJoined = false;
+};
+} // namespace coco
\ No newline at end of file
@@ -4,14 +4,20 @@
 #include "coco/util/lockfree_queue.hpp"
 #include "coco/worker_job.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <queue>
 #include <unordered_set>
+#include <vector>
 
 namespace coco {
+class Proactor;
 using Instant = std::chrono::steady_clock::time_point;
 using Duration = std::chrono::steady_clock::duration;
 
+// the proactor a timer is armed on, kept up to date when the timer moves to another thread's proactor
+using TimerOwner = std::atomic<Proactor*>;
+
 enum class TimerOpKind : std::uint8_t {
   Add,
   Delete,
@@ -23,12 +29,14 @@ struct TimerOp {
     WorkerJob* job;
     void* jobId;
   };
+  TimerOwner* owner;
   TimerOpKind kind;
 };
 
 struct TimerItem {
   Instant instant;
   WorkerJob* job;
+  TimerOwner* owner;
 };
 
 inline auto operator<(TimerItem const& lhs, TimerItem const& rhs) noexcept -> bool { return lhs.instant < rhs.instant; }
@@ -40,13 +48,22 @@ public:
   ~TimerManager() = default;
 
   // MT-Safe
-  auto addTimer(Instant time, WorkerJob* job) noexcept -> void;
+  auto addTimer(Instant time, WorkerJob* job, TimerOwner* owner = nullptr) noexcept -> void;
   // MT-Safe
   auto deleteTimer(void* id) noexcept -> void;
+  // removes the timer of `job` right away instead of when it expires, returns false if it isn't armed any more.
+  // Owner thread only.
+  auto cancelTimer(WorkerJob* job) -> bool;
   auto nextInstant() const noexcept -> Instant;
   auto processTimers() -> std::pair<WorkerJobQueue, std::size_t>;
+  // no timers left, counting the ones added but not processed yet
+  auto empty() -> bool;
+  // removes all timers which aren't deleted, e.g. to hand them to another thread's manager
+  auto takeAll() -> std::vector<TimerItem>;
 
 private:
+  auto applyPendingOps() -> void;
+
   std::mutex mPendingJobsMt;
   std::queue<TimerOp> mPendingJobs;
   std::unordered_set<void*> mDeleted;
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "coco/mt_executor.hpp"
+#include "coco/util/spsc_ring.hpp"
+
+namespace coco {
+class TpcExecutor;
+
+// one core of `TpcExecutor`: a run queue only its own thread touches, its own proactor, and one ring per sending
+// core so that cores never contend on a shared queue
+class Core {
+public:
+  Core(TpcExecutor* executor, std::uint32_t id, std::size_t coreCount);
+  Core(Core const&) = delete;
+  auto operator=(Core const&) -> Core& = delete;
+  ~Core() noexcept;
+
+  auto loop() -> void;
+  auto stop() noexcept -> void;
+  // queue a job sent from `sender`, nullptr if it comes from outside the executor. Any thread.
+  auto send(WorkerJob* job, Core* sender) noexcept -> void;
+  auto send(WorkerJobQueue jobs, Core* sender) noexcept -> void;
+  // owner only
+  auto pushLocal(WorkerJob* job, ExeOpt opt) noexcept -> void;
+  auto pushLocal(WorkerJobQueue jobs) noexcept -> void
+  {
+    if constexpr (kStatsEnabled) {
+      for (auto job = jobs.front(); job != nullptr; job = job->next) {
+        mStats.mLocalEnqueues.add();
+      }
+    }
+    mRunQueue.append(std::move(jobs));
+  }
+
+private:
+  friend class TpcExecutor;
+
+  auto drain() noexcept -> void;
+  auto runQueued() -> void;
+  auto park() -> void;
+  auto hasWork() const noexcept -> bool;
+  auto notify(Core* sender) -> void;
+
+  constexpr static std::uint32_t kRingSize = 256;
+
+  Proactor* mProactor = nullptr;
+  TpcExecutor* mExecutor;
+  std::uint32_t mId;
+  WorkerJobQueue mRunQueue;
+  // `mRings[i]` is written by core i only
+  std::vector<std::unique_ptr<util::SpscRing<WorkerJob, kRingSize>>> mRings;
+  // sends from threads outside the executor, and from cores whose ring to us is full
+  util::MpscQueue<&WorkerJob::next> mInbox;
+  std::atomic_bool mStop = false;
+  std::atomic_uint64_t mSent = 0;      // jobs this core sent to others over the rings
+  std::atomic_uint64_t mOverflows = 0; // sends of this core which found the ring full and took the inbox
+  detail::WorkerCounters mStats;
+};
+
+// Thread-per-core executor. Every core runs its own loop with its own proactor, and a job stays on the core which
+// queued it: spawning, waking and yielding from a core all go to its local run queue. Jobs only move with
+// `ExeOpt::on(core)`, which posts them over a per-pair single-producer ring and wakes the target with
+// IORING_OP_MSG_RING when the kernel supports it. Jobs queued from outside the executor are spread round-robin.
+// Pair it with `sys::TcpListener::bindShard()`, so that each core accepts its own connections.
+class TpcExecutor : public Executor {
+public:
+  // uses the placement, budget and `mMsgRing` fields of `opt`
+  TpcExecutor(std::size_t coreCount, MtOpt opt = {});
+  ~TpcExecutor() noexcept override
+  {
+    requestStop();
+    join();
+  }
+  auto requestStop() noexcept -> void;
+  auto join() noexcept -> void;
+  auto execute(WorkerJob* job, ExeOpt opt) noexcept -> void override;
+  auto execute(WorkerJobQueue&& queue, std::size_t count, ExeOpt opt) noexcept -> void override;
+  auto concurrency() const noexcept -> std::size_t override { return mCores.size(); }
+  // from a core every batch stays on it, from outside batch i goes to core i
+  auto executeBatches(std::span<WorkerJobQueue> batches, ExeOpt opt) noexcept -> void override;
+  auto runMain(Task<> task) -> void override;
+
+  auto option() const noexcept -> MtOpt const& { return mOpt; }
+  auto placement() const noexcept -> std::span<WorkerPlacement const> { return mPlacement; }
+  // jobs moved between cores over the rings, and the ones which found the ring full and took the shared inbox
+  auto sent() const noexcept -> std::uint64_t;
+  auto overflows() const noexcept -> std::uint64_t;
+  // per core scheduler counters, all zero unless built with COCO_STATS. A core has no class queues, so its queue
+  // high water mark stays 0, and its push failures are the sends which overflowed a ring.
+  auto stats() const -> RuntimeStats;
+
+private:
+  friend class Core;
+
+  // the core the calling thread runs, nullptr outside this executor
+  auto current() const noexcept -> Core*;
+  // the core `job` runs on, which it keeps from its first queueing unless moved with `ExeOpt::on()`
+  auto homeOf(WorkerJob* job, ExeOpt opt, Core* self) noexcept -> std::uint32_t;
+
+  MtOpt const mOpt;
+  std::vector<std::unique_ptr<Core>> mCores;
+  std::vector<std::thread> mThreads;
+  sys::CpuTopology mTopology;
+  std::vector<WorkerPlacement> mPlacement;
+  enum class Phase : std::uint8_t {
+    Building, // cores may send to each other only once all of them are built
+    Running,
+    Stopped, // requestStop() is done notifying, cores may release their thread local state
+  };
+  std::atomic<Phase> mPhase = Phase::Building;
+  std::atomic_uint32_t mNextCore = 0;
+};
+} // namespace coco
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace coco {
+#ifdef COCO_TRACE
+constexpr inline bool kTraceEnabled = true;
+#else
+constexpr inline bool kTraceEnabled = false;
+#endif
+
+enum class TraceKind : std::uint8_t {
+  Spawn,      // a task frame was created
+  Run,        // a worker resumed the task
+  Suspend,    // the resumption returned, the task suspended or finished
+  Await,      // the task awaits `mName`
+  Complete,   // the task finished
+  Io,         // an io completion for the task arrived, `mArg` is the result
+  RoundBegin, // a worker starts a round of queued jobs
+  RoundEnd,   // `mArg` is the number of jobs the round took from the queues
+};
+
+struct TraceEvent {
+  std::uint64_t mNs;   // steady clock
+  std::uint64_t mTask; // address of the task's promise, 0 for worker events
+  std::uint64_t mArg;
+  char const* mName; // `traceName()` of the awaitable for `Await`
+  TraceKind mKind;
+  std::uint32_t mThread; // index of the buffer which recorded it
+};
+
+// Task lifecycle tracing. Every thread records into its own ring of the last `kCapacity` events, which only it
+// writes, and `exportChrome()` dumps all rings as Chrome trace / Perfetto JSON, so a trace can be opened in
+// chrome://tracing or ui.perfetto.dev. Without COCO_TRACE the hooks are compiled out, with it they cost one relaxed
+// load until `start()`.
+class Tracer {
+public:
+  constexpr static std::size_t kCapacity = 1 << 14;
+
+  static auto start() noexcept -> void;
+  static auto stop() noexcept -> void;
+  static auto enabled() noexcept -> bool;
+  // drops the events recorded so far
+  static auto clear() noexcept -> void;
+  // label of the calling thread's track, e.g. "worker" 3
+  static auto nameThread(char const* role, std::uint32_t index) noexcept -> void;
+  static auto record(TraceKind kind, void const* task, std::uint64_t arg, char const* name) noexcept -> void;
+  // events of all threads, oldest first per thread. Safe while other threads record, events overwritten during the
+  // copy are left out.
+  static auto snapshot() -> std::vector<TraceEvent>;
+  static auto exportChrome() -> std::string;
+};
+
+namespace detail {
+inline std::atomic_bool gTracing{false};
+} // namespace detail
+
+inline auto Tracer::enabled() noexcept -> bool { return detail::gTracing.load(std::memory_order_relaxed); }
+
+// the name the exporter shows for an awaited `T`, resolved when exporting
+template <typename T>
+constexpr auto traceName() noexcept -> char const*
+{
+  return __PRETTY_FUNCTION__;
+}
+
+#ifdef COCO_TRACE
+inline auto trace(TraceKind kind, void const* task, std::uint64_t arg = 0, char const* name = nullptr) noexcept
+    -> void
+{
+  if (Tracer::enabled()) [[unlikely]] {
+    Tracer::record(kind, task, arg, name);
+  }
+}
+#else
+inline auto trace(TraceKind, void const*, std::uint64_t = 0, char const* = nullptr) noexcept -> void {}
+#endif
+} // namespace coco
\ No newline at end of file
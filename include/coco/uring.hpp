@@ -1,5 +1,6 @@
 #pragma once
 
+#include <fcntl.h>
 #include <liburing.h>
 #include <sys/eventfd.h>
 #include <sys/poll.h>
@@ -20,6 +21,8 @@ class WorkerJob;
 class MtExecutor;
 
 constexpr std::uint32_t kIoUringQueueSize = 2048;
+// slots of the registered file table every ring sets up for direct descriptors
+constexpr std::uint32_t kFileTableSize = 4096;
 using Token = void*;
 
 template <typename Rep, typename Ratio>
@@ -39,16 +42,41 @@ public:
   IoUring(IoUring&& other) = delete;
   auto operator=(IoUring&& other) -> IoUring& = delete;
 
+  // the ring can be given back and set up again while the eventfd stays, so that notify() is always safe to call
+  auto open() -> void;
+  auto close() noexcept -> void;
+  auto isOpen() const noexcept -> bool { return mOpen; }
+  // the ring has a sparse file table, the kernel installs accepted or opened files into a free slot of it and hands
+  // out the slot instead of an fd. False if the kernel can't allocate slots (before 5.19).
+  auto fileTable() const noexcept -> bool { return mFileTable; }
+
   auto prepRecv(Token token, int fd, std::span<std::byte> buf, int flag = 0) noexcept -> void;
   auto prepSend(Token token, int fd, std::span<std::byte const> buf, int flag = 0) noexcept -> void;
+  // the kernel picks the buffer from the group `group` once data arrived, the cqe names it in its flags
+  auto prepRecvSelect(Token token, int fd, std::uint16_t group) noexcept -> void;
+  // same as `prepRecvSelect()`, but one cqe per receive carrying IORING_CQE_F_MORE until the last one
+  auto prepRecvMultishot(Token token, int fd, std::uint16_t group) noexcept -> void;
   auto prepRecvMsg(Token token, int fd, ::msghdr* msg, unsigned flag = 0) noexcept -> void;
   auto prepSendMsg(Token token, int fd, ::msghdr* msg, unsigned flag = 0) noexcept -> void;
   auto prepAccept(Token token, int fd, sockaddr* addr, socklen_t* addrlen, int flags = 0) noexcept -> void;
   auto prepAcceptMt(Token token, int fd, sockaddr* addr, socklen_t* addrlen, int flags = 0) noexcept -> void;
   auto prepConnect(Token token, int fd, sockaddr* addr, socklen_t addrlen) noexcept -> void;
+  // accepts into a free slot of the file table, the result is the slot, see `fileTable()`
+  auto prepAcceptDirect(Token token, int fd) noexcept -> void;
+  auto prepAcceptMtDirect(Token token, int fd) noexcept -> void;
+  // `path` is read when the sqe is submitted
+  auto prepOpenAt(Token token, char const* path, int flags, mode_t mode) noexcept -> void;
+  auto prepOpenAtDirect(Token token, char const* path, int flags, mode_t mode) noexcept -> void;
+  // the fd of the sqe prepped last is a slot of the file table (IOSQE_FIXED_FILE)
+  auto fixedFile() noexcept -> void { mLastSqe->flags |= IOSQE_FIXED_FILE; }
 
   auto prepRead(Token token, int fd, std::span<std::byte> buf, off_t offset) noexcept -> void;
   auto prepWrite(Token token, int fd, std::span<std::byte const> buf, off_t offset) noexcept -> void;
+  // `buf` lies in the buffer registered at `index`, see `registerBuffers()`
+  auto prepReadFixed(Token token, int fd, std::span<std::byte> buf, off_t offset, int index) noexcept -> void;
+  auto prepWriteFixed(Token token, int fd, std::span<std::byte const> buf, off_t offset, int index) noexcept -> void;
+  // completes with two cqes: the result carrying IORING_CQE_F_MORE, then IORING_CQE_F_NOTIF once `buf` is free again
+  auto prepSendZcFixed(Token token, int fd, std::span<std::byte const> buf, int index) noexcept -> void;
   template <typename Rep, typename Ratio>
   auto prepAddTimeout(Token token, std::chrono::duration<Rep, Ratio> timeout) noexcept -> void
   {
@@ -75,7 +103,17 @@ public:
   }
   auto prepCancel(int fd) noexcept -> void;
   auto prepCancel(Token token) noexcept -> void;
+  // IORING_OP_ASYNC_CANCEL of the operation submitted with `target`, its own cqe carries no token
+  auto prepAsyncCancel(Token target) noexcept -> void;
+  auto prepTimeout(Token token, __kernel_timespec* spec) noexcept -> void;
   auto prepClose(Token token, int fd) noexcept -> void;
+  // frees the slot `slot` of the file table, the file is closed once no operation uses it anymore
+  auto prepCloseDirect(Token token, int slot) noexcept -> void;
+
+  // registrations are dropped with the ring, register again after `open()`
+  auto registerBuffers(std::span<::iovec const> iovecs) noexcept -> std::errc;
+  // `ring` of `entries` buffers as the buffer group `group`, the memory stays with the caller
+  auto registerBufRing(::io_uring_buf_ring* ring, std::uint32_t entries, std::uint16_t group) noexcept -> std::errc;
 
   auto seen(io_uring_cqe* cqe) noexcept -> void;
   auto advance(std::uint32_t n) noexcept -> void;
@@ -99,15 +137,26 @@ public:
     return r < 0 ? std::errc(-r) : std::errc(0);
   }
 
-  // TODO: I can't find a method to notify a uring without a real fd :(.
+  // wakes the ring through its eventfd, works on every kernel. See `prepMsgRing()` for the ring to ring path.
   auto notify() noexcept -> void;
+  // posts a cqe carrying `data` as user_data straight into the ring `targetFd`. This ring only gets a cqe, with
+  // `token` as user_data, if that fails. Needs IORING_OP_MSG_RING, see `msgRingSupported()`.
+  auto prepMsgRing(Token token, int targetFd, std::uint64_t data) noexcept -> void;
+  auto msgRingSupported() const noexcept -> bool { return mMsgRing; }
+  auto ringFd() const noexcept -> int { return mUring.ring_fd; }
   auto uring() -> ::io_uring* { return &mUring; }
+  // completions waiting in the cq ring, reads shared memory only
+  auto ready() const noexcept -> std::uint32_t { return ::io_uring_cq_ready(&mUring); }
 
 private:
   auto fetchSqe() -> io_uring_sqe*;
 
 private:
   int mEventFd;
+  bool mOpen = false;
+  bool mMsgRing = false;
+  bool mFileTable = false;
+  ::io_uring_sqe* mLastSqe = nullptr;
   ::io_uring mUring;
 };
 } // namespace coco
\ No newline at end of file
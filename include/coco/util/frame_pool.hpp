@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace coco::util {
+struct FramePoolStats {
+  std::uint64_t mAllocs = 0;
+  std::uint64_t mHits = 0;
+  std::uint64_t mRetainedBytes = 0;
+};
+
+// Per-thread size-class freelists for coroutine frames.
+// A frame freed on the thread which allocated it goes back to that thread's freelist. Frames freed on another thread
+// are collected in small batches and handed back to the owner through a lock-free stack, which the owner drains when
+// its freelist runs dry. Pools of exited threads are kept and adopted by the next new thread.
+class FramePool {
+public:
+  static auto allocate(std::size_t size) -> void*;
+  static auto deallocate(void* ptr, std::size_t size) noexcept -> void;
+  // summed over all pools, counters are relaxed so the result is approximate
+  static auto stats() noexcept -> FramePoolStats;
+
+private:
+  struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Header {
+    FramePool* mOwner;
+    std::uint32_t mClass;
+  };
+  // overlaid on the payload of a free frame
+  struct FreeFrame {
+    FreeFrame* mNext;
+  };
+  struct FreeList {
+    FreeFrame* mHead = nullptr;
+    std::uint32_t mCount = 0;
+  };
+  struct RemoteBatch {
+    FramePool* mOwner = nullptr;
+    FreeFrame* mHead = nullptr;
+    FreeFrame* mTail = nullptr;
+    std::uint32_t mCount = 0;
+  };
+
+  constexpr static std::size_t kGranularity = 64;
+  constexpr static std::size_t kClassCount = 32; // frames up to 2 KiB including the header
+  constexpr static std::uint32_t kMaxCached = 256;
+  constexpr static std::uint32_t kRemoteBatch = 32;
+  constexpr static std::size_t kRemoteSlots = 4;
+
+  static auto local() -> FramePool&;
+  static auto adopt() -> FramePool*;
+  auto release() noexcept -> void;
+
+  auto reclaim() noexcept -> void;
+  auto freeRemote(FreeFrame* frame, FramePool* owner) noexcept -> void;
+  static auto flush(RemoteBatch& batch) noexcept -> void;
+  auto addCounter(std::atomic_uint64_t& counter, std::int64_t n) noexcept -> void
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  std::array<FreeList, kClassCount> mFree{};
+  std::array<RemoteBatch, kRemoteSlots> mRemote{};
+  std::uint32_t mNextRemoteSlot = 0;
+  std::atomic<FreeFrame*> mRemoteFree{nullptr};
+  std::atomic_bool mOrphaned{false};
+  FramePool* mRegistryNext = nullptr;
+
+  std::atomic_uint64_t mAllocs{0};
+  std::atomic_uint64_t mHits{0};
+  std::atomic_uint64_t mRetainedBytes{0};
+};
+} // namespace coco::util
\ No newline at end of file
@@ -38,6 +38,24 @@ public:
     siftDown(0);
     return true;
   }
+  // removes the first element `pred` matches, linear in the size
+  template <typename Pred>
+  auto eraseIf(Pred&& pred) -> bool
+  {
+    for (std::size_t i = 0; i < mData.size(); i++) {
+      if (!pred(mData[i])) {
+        continue;
+      }
+      mData[i] = mData.back();
+      mData.pop_back();
+      if (i < mData.size()) {
+        siftUp(i);
+        siftDown(i);
+      }
+      return true;
+    }
+    return false;
+  }
   auto top() -> T& { return mData[0]; }
   auto top() const -> T const& { return mData[0]; }
 
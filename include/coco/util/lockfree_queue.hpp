@@ -26,6 +26,54 @@ public:
     return Queue<next>::from(mHead.exchange(nullptr, std::memory_order_acq_rel));
   }
 
+private:
+  atomic_node_pointer mHead{nullptr};
+};
+
+// Intrusive multi-producer single-consumer FIFO queue. Producers never block, the consumer takes everything in one
+// atomic exchange. Items are stored in reverse order and flipped back by popAll().
+template <auto next>
+class MpscQueue;
+template <typename Item, Item* Item::*next>
+class MpscQueue<next> {
+public:
+  using node_pointer = Item*;
+  using atomic_node_pointer = std::atomic<node_pointer>;
+
+  auto empty() const noexcept -> bool { return mHead.load(std::memory_order_relaxed) == nullptr; }
+  auto push(node_pointer t) noexcept -> void
+  {
+    node_pointer oldHead = mHead.load(std::memory_order_relaxed);
+    do {
+      t->*next = oldHead;
+    } while (!mHead.compare_exchange_weak(oldHead, t, std::memory_order_release, std::memory_order_relaxed));
+  }
+  auto push(Queue<next> items) noexcept -> void
+  {
+    if (items.empty()) {
+      return;
+    }
+    auto last = items.front();
+    node_pointer first = nullptr;
+    while (auto item = items.popFront()) {
+      item->*next = first;
+      first = item;
+    }
+    node_pointer oldHead = mHead.load(std::memory_order_relaxed);
+    do {
+      last->*next = oldHead;
+    } while (!mHead.compare_exchange_weak(oldHead, first, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  // consumer only
+  auto popAll() noexcept -> Queue<next>
+  {
+    if (empty()) {
+      return {};
+    }
+    return Queue<next>::from(mHead.exchange(nullptr, std::memory_order_acquire));
+  }
+
 private:
   atomic_node_pointer mHead{nullptr};
 };
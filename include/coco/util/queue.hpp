@@ -123,6 +123,28 @@ public:
     other.mHead = nullptr;
   }
 
+  // unlinks `item`, returns false if it isn't queued. Walks the queue.
+  auto remove(Item* item) noexcept -> bool
+  {
+    Item* prev = nullptr;
+    for (auto cur = mHead; cur != nullptr; prev = cur, cur = cur->*next) {
+      if (cur != item) {
+        continue;
+      }
+      if (prev == nullptr) {
+        mHead = cur->*next;
+      } else {
+        prev->*next = cur->*next;
+      }
+      if (mTail == cur) {
+        mTail = prev;
+      }
+      cur->*next = nullptr;
+      return true;
+    }
+    return false;
+  }
+
   auto front() noexcept -> Item* { return mHead; }
   auto back() noexcept -> Item* { return mTail; }
 
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace coco::util {
+// Bounded single-producer single-consumer ring of pointers.
+// Each side caches the other side's index and only reloads it when the ring looks full or empty, so a steady stream
+// of items costs no cache line ping-pong on the indices.
+template <typename T, std::uint32_t N>
+class SpscRing {
+  static_assert(N > 1 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+  SpscRing() noexcept = default;
+  SpscRing(SpscRing const&) = delete;
+  auto operator=(SpscRing const&) -> SpscRing& = delete;
+
+  constexpr static auto capacity() noexcept -> std::uint32_t { return N; }
+
+  // producer only
+  auto push(T* item) noexcept -> bool
+  {
+    auto tail = mTail.load(std::memory_order_relaxed);
+    if (tail - mHeadCache >= N) {
+      mHeadCache = mHead.load(std::memory_order_acquire);
+      if (tail - mHeadCache >= N) {
+        return false;
+      }
+    }
+    mBuffer[tail & kMask] = item;
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // consumer only
+  auto pop() noexcept -> T*
+  {
+    auto head = mHead.load(std::memory_order_relaxed);
+    if (head == mTailCache) {
+      mTailCache = mTail.load(std::memory_order_acquire);
+      if (head == mTailCache) {
+        return nullptr;
+      }
+    }
+    auto item = mBuffer[head & kMask];
+    mHead.store(head + 1, std::memory_order_release);
+    return item;
+  }
+
+  auto size() const noexcept -> std::uint32_t
+  {
+    auto tail = mTail.load(std::memory_order_acquire);
+    auto head = mHead.load(std::memory_order_acquire);
+    return tail > head ? std::uint32_t(tail - head) : 0;
+  }
+  auto empty() const noexcept -> bool { return size() == 0; }
+
+private:
+  constexpr static std::uint64_t kMask = N - 1;
+
+  alignas(64) std::atomic_uint64_t mHead{0};
+  std::uint64_t mTailCache = 0; // consumer's copy
+  alignas(64) std::atomic_uint64_t mTail{0};
+  std::uint64_t mHeadCache = 0; // producer's copy
+  alignas(64) std::array<T*, N> mBuffer{};
+};
+} // namespace coco::util
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace coco::util {
+// Bounded Chase-Lev style work-stealing deque of pointers.
+// Only the owner thread may call push()/pop()/stealInto(), any thread may steal from it. Unlike the classic
+// Chase-Lev deque the owner also consumes from the top, so local execution order stays FIFO.
+template <typename T, std::uint32_t N>
+class WsDeque {
+  static_assert(N > 1 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+  WsDeque() noexcept = default;
+  WsDeque(WsDeque const&) = delete;
+  auto operator=(WsDeque const&) -> WsDeque& = delete;
+
+  constexpr static auto capacity() noexcept -> std::uint32_t { return N; }
+
+  // owner only
+  auto push(T* item) noexcept -> bool
+  {
+    auto bottom = mBottom.load(std::memory_order_relaxed);
+    auto top = mTop.load(std::memory_order_acquire);
+    if (bottom - top >= N) {
+      return false;
+    }
+    mBuffer[bottom & kMask].store(item, std::memory_order_relaxed);
+    mBottom.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  // owner only
+  auto pop() noexcept -> T*
+  {
+    auto top = mTop.load(std::memory_order_acquire);
+    while (true) {
+      auto bottom = mBottom.load(std::memory_order_relaxed);
+      if (top >= bottom) {
+        return nullptr;
+      }
+      auto item = mBuffer[top & kMask].load(std::memory_order_relaxed);
+      if (mTop.compare_exchange_weak(top, top + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return item;
+      }
+    }
+  }
+
+  // called by the owner of `dst`, moves half of this deque into `dst`, returns the number of stolen items.
+  auto stealInto(WsDeque& dst) noexcept -> std::uint32_t
+  {
+    auto dstBottom = dst.mBottom.load(std::memory_order_relaxed);
+    auto dstFree = N - std::uint32_t(dstBottom - dst.mTop.load(std::memory_order_acquire));
+    auto top = mTop.load(std::memory_order_acquire);
+    while (true) {
+      auto bottom = mBottom.load(std::memory_order_acquire);
+      if (top >= bottom) {
+        return 0;
+      }
+      auto n = std::uint32_t(bottom - top);
+      n = std::min(n - n / 2, dstFree);
+      if (n == 0) {
+        return 0;
+      }
+      for (std::uint32_t i = 0; i < n; i++) {
+        auto item = mBuffer[(top + i) & kMask].load(std::memory_order_relaxed);
+        dst.mBuffer[(dstBottom + i) & kMask].store(item, std::memory_order_relaxed);
+      }
+      if (mTop.compare_exchange_weak(top, top + n, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        dst.mBottom.store(dstBottom + n, std::memory_order_release);
+        return n;
+      }
+    }
+  }
+
+  auto size() const noexcept -> std::uint32_t
+  {
+    auto bottom = mBottom.load(std::memory_order_acquire);
+    auto top = mTop.load(std::memory_order_acquire);
+    return bottom > top ? std::uint32_t(bottom - top) : 0;
+  }
+  auto empty() const noexcept -> bool { return size() == 0; }
+
+private:
+  constexpr static std::uint64_t kMask = N - 1;
+
+  alignas(64) std::atomic_uint64_t mTop{0};
+  alignas(64) std::atomic_uint64_t mBottom{0};
+  std::array<std::atomic<T*>, N> mBuffer{};
+};
+} // namespace coco::util
\ No newline at end of file
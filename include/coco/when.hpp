@@ -0,0 +1,299 @@
+#pragma once
+
+#include "coco/task.hpp"
+
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+namespace coco {
+namespace detail {
+constexpr inline std::size_t kNoWinner = ~std::size_t(0);
+
+// state of one `whenAny()` / `whenAll()`, shared by its branches. It lives in the awaiting coroutine's frame.
+struct WhenCore {
+  using CancelFn = void (*)(WhenCore* core) noexcept;
+
+  auto done(std::size_t index) noexcept -> void
+  {
+    if (mCancelLosers != nullptr) {
+      auto expected = kNoWinner;
+      if (mWinner.compare_exchange_strong(expected, index, std::memory_order_acq_rel)) {
+        passGate();
+      }
+    }
+    release();
+  }
+  // the losers are cancelled once there is a winner and every branch is started, by whichever comes second
+  auto passGate() noexcept -> void
+  {
+    if (mGate.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      mCancelLosers(this);
+    }
+  }
+  auto release() noexcept -> void
+  {
+    if (mPending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      runJob(mParent, kWorkerArgNull);
+    }
+  }
+
+  // unfinished branches, plus one for the parent until it started them all
+  std::atomic_size_t mPending{0};
+  std::atomic_size_t mWinner{kNoWinner};
+  std::atomic_uint8_t mGate{2};
+  WorkerJob* mParent = nullptr;
+  Proactor* mProactor = nullptr;
+  CancelFn mCancelLosers = nullptr; // only set by `whenAny()`
+  void* mOwner = nullptr;           // the `WhenAwaiter`
+};
+
+// stands in for the awaiting coroutine's promise in a branch. Awaiters resume their coroutine by running the
+// promise's `getThisJob()`, which here reports the branch as done instead. There is no coroutine frame behind it,
+// so it is handed to the awaiter's `suspend(PromiseBase&)` and never as a `std::coroutine_handle`.
+struct BranchPromise : PromiseBase {
+  BranchPromise() noexcept { mThisJob.WorkerJob::run = &BranchPromise::run; }
+
+  static auto run(WorkerJob* job, WorkerArg /* arg */) noexcept -> void
+  {
+    auto self = static_cast<BranchPromise*>(static_cast<CoroJob*>(job)->promise);
+    self->mCore->done(self->mIndex);
+  }
+
+  WhenCore* mCore = nullptr;
+  std::size_t mIndex = 0;
+};
+
+template <typename T>
+using BranchValue = std::conditional_t<std::is_void_v<T>, std::monostate, std::remove_cvref_t<T>>;
+
+template <typename Awaiter>
+concept IoAwaiter = requires(Awaiter& awaiter) { awaiter.mIoJob; };
+
+// an awaiter which suspends on a bare promise: `suspend(promise)` does what `await_suspend(handle)` does with
+// `handle.promise()` and touches nothing else of the awaiting coroutine
+template <typename Awaiter>
+concept BranchAwaiter = requires(Awaiter& awaiter, PromiseBase& promise) { awaiter.suspend(promise); };
+
+// an awaiter run as a branch. A loser is cancelled through the proactor it suspended on: io awaiters with
+// IORING_OP_ASYNC_CANCEL of their `mIoJob`, others through their `cancel(Proactor&)`, which returns where it queued a
+// cancel and its token, or nullptrs.
+template <typename Awaiter>
+struct Branch {
+  using Value = BranchValue<decltype(std::declval<Awaiter&>().await_resume())>;
+  constexpr static bool kCancellable =
+      IoAwaiter<Awaiter> || requires(Awaiter& awaiter, Proactor& owner) { awaiter.cancel(owner); };
+
+  static_assert(BranchAwaiter<Awaiter>, "a branch awaiter needs `suspend(PromiseBase&)`, or wrap it in a task");
+
+  explicit Branch(Awaiter&& awaiter) noexcept : mAwaiter(std::move(awaiter)) {}
+
+  // false if the branch completed without suspending
+  auto start(PromiseBase& /* parent */) noexcept -> bool
+  {
+    if (mAwaiter.await_ready()) {
+      return false;
+    }
+    using Suspend = decltype(mAwaiter.suspend(mPromise));
+    static_assert(std::is_void_v<Suspend> || std::is_same_v<Suspend, bool>, "symmetric transfer isn't supported");
+    if constexpr (std::is_void_v<Suspend>) {
+      mAwaiter.suspend(mPromise);
+      return true;
+    } else {
+      return mAwaiter.suspend(mPromise);
+    }
+  }
+  auto cancel(WhenCore& core) noexcept -> void
+  {
+    if constexpr (IoAwaiter<Awaiter>) {
+      static_assert(!requires { mAwaiter.mTimeout; } && !requires { mAwaiter.mToken; },
+                    "timeouts and tokens don't mix with whenAny(), race the plain awaiter against a sleep instead");
+      core.mProactor->addCancel(CancelItem::cancelJob(&mAwaiter.mIoJob));
+      mCancelOwner = core.mProactor;
+      mCancelToken = &mAwaiter.mIoJob;
+    } else {
+      std::tie(mCancelOwner, mCancelToken) = mAwaiter.cancel(*core.mProactor);
+    }
+  }
+  // a cancel which is still queued must not hit the next operation which reuses the token
+  auto dropCancel(WhenCore& /* core */) -> void
+  {
+    if (mCancelToken != nullptr) {
+      mCancelOwner->dropCancel(mCancelToken);
+    }
+  }
+  auto value() -> Value
+  {
+    if constexpr (std::is_void_v<decltype(mAwaiter.await_resume())>) {
+      mAwaiter.await_resume();
+      return {};
+    } else {
+      return mAwaiter.await_resume();
+    }
+  }
+
+  Awaiter mAwaiter;
+  BranchPromise mPromise;
+  Proactor* mCancelOwner = nullptr;
+  Token mCancelToken = nullptr;
+};
+
+// a task run as a branch. It starts on the awaiting thread like an awaited task, a loser isn't stopped but detached:
+// it finishes on its own and frees its frame.
+template <typename T>
+struct Branch<Task<T>> {
+  using Value = BranchValue<T>;
+  constexpr static bool kCancellable = true;
+
+  explicit Branch(Task<T>&& task) noexcept : mTask(std::move(task)) {}
+
+  auto start(PromiseBase& parent) noexcept -> bool
+  {
+    auto& promise = mTask.promise();
+    promise.setPriority(parent.priority());
+    promise.getThisJob()->home = parent.getThisJob()->home;
+    promise.setNextJob(&detail::kEmptyJob);
+    mTask.handle().resume();
+    detail::tCurrentPriority = parent.priority();
+    WorkerJob* expected = &detail::kEmptyJob;
+    return promise.getNextJob().compare_exchange_strong(expected, mPromise.getThisJob());
+  }
+  auto cancel(WhenCore& core) noexcept -> void
+  {
+    WorkerJob* expected = mPromise.getThisJob();
+    if (mTask.promise().getNextJob().compare_exchange_strong(expected, &detail::kDetachJob)) {
+      [[maybe_unused]] auto handle = mTask.take();
+      core.release(); // the branch won't report any more
+    }
+  }
+  auto dropCancel(WhenCore& /* core */) -> void {}
+  auto value() -> Value
+  {
+    if constexpr (std::is_void_v<T>) {
+      mTask.promise().result();
+      return {};
+    } else {
+      return std::move(mTask.promise()).result();
+    }
+  }
+
+  Task<T> mTask;
+  BranchPromise mPromise;
+};
+
+enum class WhenMode { Any, All };
+
+template <WhenMode Mode, typename... Awaitables>
+class [[nodiscard]] WhenAwaiter {
+public:
+  explicit WhenAwaiter(Awaitables&&... awaitables) noexcept : mBranches(std::move(awaitables)...)
+  {
+    if constexpr (Mode == WhenMode::Any) {
+      static_assert((Branch<Awaitables>::kCancellable && ...), "whenAny() needs awaiters it can cancel");
+      mCore.mCancelLosers = &cancelLosers;
+      mCore.mOwner = this;
+    }
+    forEach([this](auto& branch, std::size_t index) {
+      branch.mPromise.mCore = &mCore;
+      branch.mPromise.mIndex = index;
+    });
+  }
+  WhenAwaiter(WhenAwaiter const&) = delete;
+  auto operator=(WhenAwaiter const&) -> WhenAwaiter& = delete;
+
+  auto await_ready() const noexcept -> bool { return false; }
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
+  {
+    auto& parent = handle.promise();
+    mCore.mParent = parent.getThisJob();
+    mCore.mProactor = &Proactor::get();
+    mCore.mPending.store(sizeof...(Awaitables) + 1, std::memory_order_relaxed);
+    forEach([&](auto& branch, std::size_t index) {
+      branch.mPromise.setPriority(parent.priority());
+      branch.mPromise.getThisJob()->home = parent.getThisJob()->home;
+      // once a branch won, the ones after it aren't started at all
+      if (Mode == WhenMode::Any && mCore.mWinner.load(std::memory_order_acquire) != kNoWinner) {
+        mCore.mPending.fetch_sub(1, std::memory_order_relaxed);
+        return;
+      }
+      if (branch.start(parent)) {
+        mStarted[index] = true;
+      } else {
+        mCore.done(index);
+      }
+    });
+    if constexpr (Mode == WhenMode::Any) {
+      mCore.passGate();
+    }
+    return mCore.mPending.fetch_sub(1, std::memory_order_acq_rel) != 1;
+  }
+  auto await_resume()
+  {
+    if constexpr (Mode == WhenMode::Any) {
+      forEach([this](auto& branch, std::size_t) { branch.dropCancel(mCore); });
+      return winnerValue(std::make_index_sequence<sizeof...(Awaitables)>());
+    } else {
+      return std::apply([](auto&... branches) { return std::tuple(branches.value()...); }, mBranches);
+    }
+  }
+
+private:
+  using Values = std::variant<typename Branch<Awaitables>::Value...>;
+
+  template <typename Fn>
+  auto forEach(Fn&& fn) -> void
+  {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (fn(std::get<I>(mBranches), I), ...);
+    }(std::make_index_sequence<sizeof...(Awaitables)>());
+  }
+  template <std::size_t... I>
+  auto winnerValue(std::index_sequence<I...>) -> Values
+  {
+    auto const winner = mCore.mWinner.load(std::memory_order_relaxed);
+    auto values = std::optional<Values>();
+    ((winner == I ? (void)values.emplace(std::in_place_index<I>, std::get<I>(mBranches).value()) : (void)0), ...);
+    return std::move(*values);
+  }
+  static auto cancelLosers(WhenCore* core) noexcept -> void
+  {
+    auto self = static_cast<WhenAwaiter*>(core->mOwner);
+    auto const winner = core->mWinner.load(std::memory_order_relaxed);
+    self->forEach([&](auto& branch, std::size_t index) {
+      if (index != winner && self->mStarted[index]) {
+        branch.cancel(*core);
+      }
+    });
+  }
+
+  WhenCore mCore;
+  std::tuple<Branch<Awaitables>...> mBranches;
+  bool mStarted[sizeof...(Awaitables)] = {};
+};
+} // namespace detail
+
+// Waits for the first of `awaitables` and cancels the others, then returns the winner's result as the alternative
+// of the variant at its position, `std::monostate` for `void`. Works on Coco's own awaiters (socket and file io,
+// `Channel::read()`/`write()`, `Runtime::SleepAwaiter`) and on tasks, without a helper task: the state of the race
+// lives in the awaiting frame. A cancelled io resumes nothing, a losing task is detached and finishes on its own.
+// Returns once every loser acknowledged its cancel, so nothing refers to the awaiting frame afterwards.
+template <typename... Awaitables>
+  requires(sizeof...(Awaitables) > 0 && (!std::is_lvalue_reference_v<Awaitables> && ...))
+[[nodiscard]] auto whenAny(Awaitables&&... awaitables) noexcept
+{
+  return detail::WhenAwaiter<detail::WhenMode::Any, std::remove_cvref_t<Awaitables>...>(
+      std::move(awaitables)...);
+}
+
+// Waits for all of `awaitables` and returns their results as a tuple, `std::monostate` for `void`. Same as
+// `whenAny()` without the cancelling. The first exception of a task is rethrown once all of them finished.
+template <typename... Awaitables>
+  requires(sizeof...(Awaitables) > 0 && (!std::is_lvalue_reference_v<Awaitables> && ...))
+[[nodiscard]] auto whenAll(Awaitables&&... awaitables) noexcept
+{
+  return detail::WhenAwaiter<detail::WhenMode::All, std::remove_cvref_t<Awaitables>...>(
+      std::move(awaitables)...);
+}
+} // namespace coco
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "coco/util/queue.hpp"
 
 #include <coroutine>
+#include <span>
 
 namespace coco {
 inline auto genJobId() -> std::size_t
@@ -35,13 +36,32 @@ struct WorkerArg {
 };
 constexpr WorkerArg kWorkerArgNull{.ptr = nullptr};
 
+// scheduling class of a job, each worker keeps one queue per class and serves them weighted-fair, see
+// `MtOpt::mPriorityWeights`. Independent of `ExeOpt::Pri`, which only decides whether a single wakeup skips the queues.
+enum class Priority : std::uint8_t {
+  Critical,
+  Interactive,
+  Normal,
+  Background,
+};
+constexpr std::size_t kPriorityCount = 4;
+
 struct WorkerJob {
+  constexpr static std::uint8_t kNoHome = 0xff;
   using WorkerFn = void (*)(WorkerJob* task, WorkerArg args) noexcept;
   constexpr WorkerJob(WorkerFn fn, std::atomic<JobState>* state) noexcept : run(fn), next(nullptr), state(state) {}
 
   WorkerFn run;
   WorkerJob* next;
   std::atomic<JobState>* state;
+  Priority prio = Priority::Normal;
+  // a coroutine job with a deadline, see `PromiseBase::CoroJob`
+  bool hasDeadline = false;
+  // dropped instead of run if its deadline passed before it first ran
+  bool shed = false;
+  // core of a `TpcExecutor` the job lives on, so that a wakeup from another core sends it back there
+  std::uint8_t home = kNoHome;
+  std::uint32_t stamp = 0; // when the job was queued, in executor microseconds
 };
 
 using WorkerJobQueue = util::Queue<&WorkerJob::next>;
@@ -56,6 +76,8 @@ inline auto emptyFn(WorkerJob*, WorkerArg) noexcept -> void { assert(false && "e
 namespace detail {
 inline WorkerJob kEmptyJob{emptyFn, nullptr};
 inline WorkerJob kDetachJob{emptyFn, nullptr};
+// class of the coroutine running on this thread, new coroutines start in it
+inline thread_local Priority tCurrentPriority = Priority::Normal;
 } // namespace detail
 template <typename T = void>
 struct Task;
@@ -67,6 +89,8 @@ struct ExeOpt {
     Balance,
     PreferInOne,
     ForceInOne,
+    Yield, // back of the current worker's queue, behind the jobs already waiting there
+    Target, // worker `mTid`, where it stays. The only way a job moves between cores of `TpcExecutor`.
   } mOpt = Balance;
 
   enum Pri : std::uint8_t {
@@ -83,6 +107,17 @@ struct ExeOpt {
     return {.mTid = 0, .mOpt = PreferInOne, .mPri = pri};
   }
   constexpr static auto balance(Pri pri = Low) noexcept -> ExeOpt { return {.mTid = 0, .mOpt = Balance, .mPri = pri}; }
+  constexpr static auto forceInOne(Pri pri = Low) noexcept -> ExeOpt
+  {
+    return {.mTid = 0, .mOpt = ForceInOne, .mPri = pri};
+  }
+  constexpr static auto yield(Pri pri = Low) noexcept -> ExeOpt { return {.mTid = 0, .mOpt = Yield, .mPri = pri}; }
+  constexpr static auto on(std::uint16_t tid, Pri pri = Low) noexcept -> ExeOpt
+  {
+    return {.mTid = tid, .mOpt = Target, .mPri = pri};
+  }
+  // goes to the worker `mTid`, which the proactor fills in with the current one
+  constexpr auto inCurrent() const noexcept -> bool { return mOpt == PreferInOne || mOpt == Yield; }
 };
 
 class Executor {
@@ -92,6 +127,10 @@ public:
 
   virtual auto execute(WorkerJobQueue&& queue, std::size_t count, ExeOpt opt) noexcept -> void = 0;
   virtual auto execute(WorkerJob* handle, ExeOpt opt) noexcept -> void = 0;
+  // number of workers, and of batches `executeBatches()` takes
+  virtual auto concurrency() const noexcept -> std::size_t = 0;
+  // one batch per worker, each handed over with a single enqueue and at most one wakeup
+  virtual auto executeBatches(std::span<WorkerJobQueue> batches, ExeOpt opt) noexcept -> void = 0;
   virtual auto runMain(Task<> task) -> void = 0;
 };
 
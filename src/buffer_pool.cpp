@@ -0,0 +1,94 @@
+#include "coco/buffer_pool.hpp"
+
+#include "coco/proactor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace coco {
+namespace {
+std::atomic_uint32_t gCount{BufferPool::kDefaultCount};
+std::atomic_size_t gSize{BufferPool::kDefaultSize};
+
+constexpr std::size_t kPageSize = 4096;
+} // namespace
+
+auto FixedBuffer::lease() -> FixedBuffer { return Proactor::get().buffers().lease(); }
+
+auto BufferPool::configure(std::uint32_t count, std::size_t size) noexcept -> void
+{
+  gCount.store(std::clamp(count, 1u, kMaxCount), std::memory_order_relaxed);
+  gSize.store(std::max(size, kPageSize), std::memory_order_relaxed);
+}
+
+auto BufferPool::create() -> std::shared_ptr<BufferPool>
+{
+  return std::make_shared<BufferPool>(gCount.load(std::memory_order_relaxed), gSize.load(std::memory_order_relaxed));
+}
+
+BufferPool::BufferPool(std::uint32_t count, std::size_t size)
+    : mBufferSize((size + kPageSize - 1) / kPageSize * kPageSize), mCount(count)
+{
+  // page aligned, so that the buffers also serve O_DIRECT files
+  mMemory = static_cast<std::byte*>(std::aligned_alloc(kPageSize, mBufferSize * mCount));
+  if (mMemory == nullptr) {
+    throw std::bad_alloc();
+  }
+  mFree.reserve(mCount);
+  for (auto i = mCount; i > 0; i--) {
+    mFree.push_back(i - 1);
+  }
+}
+
+BufferPool::~BufferPool() { std::free(mMemory); }
+
+auto BufferPool::lease() -> FixedBuffer
+{
+  auto index = std::uint32_t(0);
+  {
+    std::lock_guard lock(mMt);
+    if (mFree.empty()) [[unlikely]] {
+      mExhausted++;
+      return FixedBuffer();
+    }
+    index = mFree.back();
+    mFree.pop_back();
+    mLeases++;
+    mHighWater = std::max(mHighWater, mCount - std::uint32_t(mFree.size()));
+  }
+  return FixedBuffer(shared_from_this(), mMemory + index * mBufferSize, index);
+}
+
+auto BufferPool::giveBack(std::uint32_t index) noexcept -> void
+{
+  std::lock_guard lock(mMt);
+  mFree.push_back(index);
+}
+
+auto BufferPool::registerWith(IoUring& ring) -> std::errc
+{
+  auto iovecs = std::vector<::iovec>(mCount);
+  for (std::uint32_t i = 0; i < mCount; i++) {
+    iovecs[i] = ::iovec{mMemory + i * mBufferSize, mBufferSize};
+  }
+  auto e = ring.registerBuffers(iovecs);
+  mRegistered = e == std::errc(0);
+  return e;
+}
+
+auto BufferPool::stats() -> BufferPoolStats
+{
+  std::lock_guard lock(mMt);
+  return BufferPoolStats{
+      .mBufferSize = mBufferSize,
+      .mCapacity = mCount,
+      .mInUse = mCount - std::uint32_t(mFree.size()),
+      .mHighWater = mHighWater,
+      .mLeases = mLeases,
+      .mExhausted = mExhausted,
+      .mRegistered = mRegistered,
+  };
+}
+} // namespace coco
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "coco/buffer_ring.hpp"
+
+#include "coco/proactor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <new>
+
+namespace coco {
+namespace {
+std::atomic_uint32_t gCount{BufferRing::kDefaultCount};
+std::atomic_size_t gSize{BufferRing::kDefaultSize};
+
+constexpr std::size_t kPageSize = 4096;
+
+auto allocPages(std::size_t size) -> void*
+{
+  auto ptr = std::aligned_alloc(kPageSize, (size + kPageSize - 1) / kPageSize * kPageSize);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+} // namespace
+
+auto BufferRing::configure(std::uint32_t count, std::size_t size) noexcept -> void
+{
+  gCount.store(std::bit_ceil(std::clamp(count, 1u, kMaxCount)), std::memory_order_relaxed);
+  gSize.store(std::max(size, std::size_t(1)), std::memory_order_relaxed);
+}
+
+auto BufferRing::create() -> std::shared_ptr<BufferRing>
+{
+  return std::make_shared<BufferRing>(gCount.load(std::memory_order_relaxed), gSize.load(std::memory_order_relaxed));
+}
+
+BufferRing::BufferRing(std::uint32_t count, std::size_t size)
+    : mBufferSize(size), mCount(std::bit_ceil(std::clamp(count, 1u, kMaxCount))), mUsed(mCount, false)
+{
+  mMemory = static_cast<std::byte*>(allocPages(mBufferSize * mCount));
+  try {
+    mRing = static_cast<::io_uring_buf_ring*>(allocPages(mCount * sizeof(::io_uring_buf)));
+  } catch (...) {
+    std::free(mMemory);
+    throw;
+  }
+  mFree.reserve(mCount);
+  for (auto i = mCount; i > 0; i--) {
+    mFree.push_back(std::uint16_t(i - 1));
+  }
+}
+
+BufferRing::~BufferRing()
+{
+  std::free(mRing);
+  std::free(mMemory);
+}
+
+auto BufferRing::registerWith(IoUring& ring) -> std::errc
+{
+  std::lock_guard lock(mMt);
+  ::io_uring_buf_ring_init(mRing);
+  auto e = ring.registerBufRing(mRing, mCount, kGroupId);
+  if (e != std::errc(0)) {
+    mRegistered = false;
+    return e;
+  }
+  mRegistered = true;
+  mFree.clear();
+  auto offset = 0;
+  for (std::uint32_t i = 0; i < mCount; i++) {
+    if (!mUsed[i]) {
+      provide(std::uint16_t(i), offset++);
+    }
+  }
+  ::io_uring_buf_ring_advance(mRing, offset);
+  return e;
+}
+
+auto BufferRing::detach() noexcept -> void
+{
+  std::lock_guard lock(mMt);
+  if (!mRegistered) {
+    return;
+  }
+  mRegistered = false;
+  for (std::uint32_t i = mCount; i > 0; i--) {
+    if (!mUsed[i - 1]) {
+      mFree.push_back(std::uint16_t(i - 1));
+    }
+  }
+}
+
+auto BufferRing::take(std::uint32_t cqeFlags, std::size_t len) -> ProvidedBuffer
+{
+  if (!(cqeFlags & IORING_CQE_F_BUFFER)) {
+    return ProvidedBuffer();
+  }
+  auto id = std::uint16_t(cqeFlags >> IORING_CQE_BUFFER_SHIFT);
+  {
+    std::lock_guard lock(mMt);
+    markUsed(id);
+    mSelected++;
+  }
+  return ProvidedBuffer(shared_from_this(), mMemory + id * mBufferSize, id, std::min(len, mBufferSize));
+}
+
+auto BufferRing::lease() -> ProvidedBuffer
+{
+  auto id = std::uint16_t(0);
+  {
+    std::lock_guard lock(mMt);
+    if (mFree.empty()) [[unlikely]] {
+      return ProvidedBuffer();
+    }
+    id = mFree.back();
+    mFree.pop_back();
+    markUsed(id);
+  }
+  return ProvidedBuffer(shared_from_this(), mMemory + id * mBufferSize, id, 0);
+}
+
+auto BufferRing::giveBack(std::uint16_t id) noexcept -> void
+{
+  std::lock_guard lock(mMt);
+  mUsed[id] = false;
+  mInUse--;
+  if (mRegistered) {
+    // the application is the only producer of the ring, the lock orders the threads releasing buffers
+    provide(id, 0);
+    ::io_uring_buf_ring_advance(mRing, 1);
+  } else {
+    mFree.push_back(id);
+  }
+}
+
+auto BufferRing::provide(std::uint16_t id, int offset) noexcept -> void
+{
+  ::io_uring_buf_ring_add(mRing, mMemory + id * mBufferSize, mBufferSize, id, ::io_uring_buf_ring_mask(mCount),
+                          offset);
+}
+
+auto BufferRing::markUsed(std::uint16_t id) noexcept -> void
+{
+  mUsed[id] = true;
+  mInUse++;
+  mHighWater = std::max(mHighWater, mInUse);
+}
+
+auto BufferRing::stats() -> BufferRingStats
+{
+  std::lock_guard lock(mMt);
+  return BufferRingStats{
+      .mBufferSize = mBufferSize,
+      .mCapacity = mCount,
+      .mInUse = mInUse,
+      .mHighWater = mHighWater,
+      .mSelected = mSelected,
+      .mRegistered = mRegistered,
+  };
+}
+} // namespace coco
\ No newline at end of file
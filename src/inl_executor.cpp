@@ -20,7 +20,7 @@ auto InlExecutor::loop() -> void
   while (true) {
     auto currState = mState;
     if (currState == State::Waiting) {
-      mProactor->wait();
+      mProactor->wait([this] { return !mTaskQueue.empty(); });
       if (mMainTaskState.load() == JobState::Final && mTaskQueue.empty()) {
         mState = State::Stop;
       } else {
@@ -55,6 +55,12 @@ auto InlExecutor::execute(WorkerJobQueue&& queue, std::size_t count, ExeOpt opt)
   mTaskQueue.append(std::move(queue));
 }
 auto InlExecutor::execute(WorkerJob* handle, ExeOpt opt) noexcept -> void { mTaskQueue.pushBack(handle); }
+auto InlExecutor::executeBatches(std::span<WorkerJobQueue> batches, ExeOpt /* opt */) noexcept -> void
+{
+  for (auto& batch : batches) {
+    mTaskQueue.append(std::move(batch));
+  }
+}
 auto InlExecutor::runMain(Task<> task) -> void
 {
   Proactor::get().attachExecutor(this, 0);
@@ -1,28 +1,59 @@
 #include "coco/mt_executor.hpp"
+#include <algorithm>
 #include <mutex>
 
 namespace coco {
+static thread_local Worker* tCurrentWorker = nullptr;
+
+static inline auto cpuRelax() noexcept -> void
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+Worker::~Worker() noexcept
+{
+  // jobs still queued at shutdown are dropped, unlink them so the queues' destructors don't complain
+  for (auto& overflow : mOverflow) {
+    while (overflow.popFront() != nullptr) {
+    }
+  }
+}
 auto Worker::forceStop() -> void
 {
+  if (mProactor == nullptr) { // never started
+    mState.store(State::Stop, std::memory_order_release);
+    return;
+  }
   auto state = mState.load(std::memory_order_acquire);
-  switch (state) {
-  case State::Waiting: {
-    notify();
-    auto r = mState.compare_exchange_strong(state, State::Stop, std::memory_order_acq_rel);
-  } break;
-  case State::Executing: {
-    auto r = mState.compare_exchange_strong(state, State::Stop, std::memory_order_acq_rel);
-  } break;
-  case State::Stop: {
+  if (state == State::Stop) {
     processTasks();
     return;
-  } break;
   }
+  while (!mState.compare_exchange_weak(state, State::Stop, std::memory_order_acq_rel)) {
+  }
+  // a worker about to park checks the state after it is marked as parked, so one notify is enough
+  notify();
+  wakeDormant();
 }
-auto Worker::start(std::latch& latch) -> void
+auto Worker::start(std::latch& latch, MtExecutor* executor, std::uint32_t tid) -> void
 {
   mProactor = &Proactor::get();
+  mExecutor = executor;
+  mTid = tid;
+  tCurrentWorker = this;
+  Tracer::nameThread("worker", tid);
   mState = State::Waiting;
+  // spinning only helps if another cpu can produce the work meanwhile
+  mSpinMax = std::thread::hardware_concurrency() > 1 ? executor->mOpt.mSpinMax : 0;
+  mSpinBudget = mSpinMax;
+  for (std::size_t i = 0; i < kPriorityCount; i++) {
+    mStride[i] = kStrideOne / std::max(executor->mOpt.mPriorityWeights[i], 1u);
+  }
+  mExecutor->mIdleCount.fetch_add(1, std::memory_order_relaxed);
   latch.count_down();
 }
 auto Worker::loop() -> void
@@ -30,13 +61,27 @@ auto Worker::loop() -> void
   while (true) {
     auto currState = mState.load(std::memory_order_relaxed);
     if (currState == State::Waiting) {
-      mProactor->wait();
+      park();
+      mExecutor->mIdleCount.fetch_sub(1, std::memory_order_relaxed);
       auto r = mState.compare_exchange_strong(currState, State::Executing, std::memory_order_acq_rel);
       if (r == false) { // must be stop
         return;
       }
     } else if (currState == State::Executing) {
       processTasks();
+      if (mRetiring.load(std::memory_order_relaxed)) [[unlikely]] {
+        if (!retire()) {
+          return;
+        }
+        continue;
+      }
+      if (queuedJobs() == 0 && trySteal()) {
+        continue;
+      }
+      if (spin()) {
+        continue;
+      }
+      mExecutor->mIdleCount.fetch_add(1, std::memory_order_relaxed);
       auto r = mState.compare_exchange_strong(currState, State::Waiting, std::memory_order_acq_rel);
       if (r == false) {
         return;
@@ -48,89 +93,531 @@ auto Worker::loop() -> void
     }
   }
 }
-auto Worker::notify() -> void { mProactor->notify(); }
+auto Worker::notify() -> void
+{
+  // a worker's ring is polled by its loop, so it can post wakeups for others
+  auto sender = tCurrentWorker;
+  auto woken = false;
+  if (sender != nullptr && sender != this && mExecutor->mOpt.mMsgRing) {
+    // a retiring worker closes its ring once no poster is left, until then it is reached through the eventfd
+    mRingUsers.fetch_add(1, std::memory_order_seq_cst);
+    woken = mRetiring.load(std::memory_order_seq_cst) ? mProactor->notify() : mProactor->notify(*sender->mProactor);
+    mRingUsers.fetch_sub(1, std::memory_order_release);
+  } else {
+    woken = mProactor->notify();
+  }
+  if (woken) {
+    mStats.mUnparks.add();
+  }
+}
 auto Worker::processTasks() -> void
 {
-  mQueueMt.lock();
-  auto jobs = std::move(mTaskQueue);
-  mQueueMt.unlock();
+  trace(TraceKind::RoundBegin, nullptr);
+  refillBudget();
+  auto const start = mNow;
+  auto const runsBefore = mStats.mJobsRun.load();
+  auto remote = std::uint64_t(0);
+  auto pinned = mPinnedInbox.popAll();
+  auto urgent = mHighInbox.popAll();
+  auto jobs = mInbox.popAll();
+  runLifoSlot(); // filled while polling io or timers
+  while (auto job = pinned.popFront()) {
+    run(job);
+    remote++;
+  }
+  while (auto job = urgent.popFront()) {
+    run(job);
+    remote++;
+  }
+  // sort remote jobs into the class queues, where idle workers can steal them
   while (auto job = jobs.popFront()) {
+    pushClass(job);
+    remote++;
+  }
+  auto queued = queuedJobs();
+  if (queued > 1 && mExecutor->mOpt.mStealing) {
+    mExecutor->wakeIdle();
+  }
+  mStats.mRemoteEnqueues.add(remote);
+  mStats.mQueueHighWater.raise(queued);
+  auto const picked = queued;
+  // only run what is queued now, jobs pushed meanwhile wait for the next round after io polling
+  for (; queued > 0; queued--) {
+    auto job = popWeighted();
+    if (job == nullptr) { // stolen
+      break;
+    }
+    run(job);
+  }
+  if constexpr (kStatsEnabled) {
+    mStats.mBatchSizes.add(mStats.mJobsRun.load() - runsBefore);
+    mStats.mBusyUs.add(detail::toMicros(std::chrono::steady_clock::now() - start));
+  }
+  trace(TraceKind::RoundEnd, nullptr, picked);
+}
+auto Worker::run(WorkerJob* job) -> void
+{
+  runJob(job, kWorkerArgNull);
+  mStats.mJobsRun.add();
+  consumeBudget();
+  runLifoSlot();
+}
+auto Worker::refillBudget() -> void
+{
+  mProactor->refillBudget(mExecutor->mOpt.mBudgetJobs, mExecutor->mOpt.mBudgetTime);
+  mNow = std::chrono::steady_clock::now();
+  mStamp = std::uint32_t(std::chrono::duration_cast<std::chrono::microseconds>(mNow - mExecutor->mEpoch).count());
+}
+auto Worker::consumeBudget() -> void
+{
+  if (mProactor->consumeBudget()) [[unlikely]] {
+    // don't let a long run of ready jobs delay io completions and timers
+    mProactor->poll();
+    mStats.mBudgetPolls.add();
+    refillBudget();
+  }
+}
+auto Worker::runLifoSlot() -> void
+{
+  for (std::uint32_t n = 0; mLifoSlot != nullptr; n++) {
+    auto job = std::exchange(mLifoSlot, nullptr);
+    if (n == kLifoSlotCap) [[unlikely]] { // don't let a ping-pong pair starve the queue
+      pushBack(job);
+      return;
+    }
+    mStats.mLifoHits.add();
     runJob(job, kWorkerArgNull);
+    mStats.mJobsRun.add();
+    consumeBudget();
   }
 }
-
-auto Worker::pushTask(WorkerJob* job, ExeOpt opt) -> void
+auto Worker::pushClass(WorkerJob* job) -> void
 {
-  mQueueMt.lock();
-  if (opt.mPri == ExeOpt::High) [[unlikely]] {
-    mTaskQueue.pushFront(job);
-  } else {
-    mTaskQueue.pushBack(job);
+  job->stamp = mStamp;
+  if (job->hasDeadline) {
+    pushDeadline(job);
+    return;
   }
-  mQueueMt.unlock();
-  notify();
+  auto const c = std::size_t(job->prio);
+  auto& count = mOverflowCount[c];
+  if (count.load(std::memory_order_relaxed) == 0 && mLocalQueues[c].push(job)) {
+    return;
+  }
+  mOverflow[c].pushBack(job);
+  count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 }
-
-auto Worker::tryPushTask(WorkerJob* job, ExeOpt opt) -> bool
+static auto deadlineOf(WorkerJob* job) noexcept -> Instant
+{
+  return static_cast<PromiseBase::CoroJob*>(job)->deadline;
+}
+static auto laterDeadline(WorkerJob* lhs, WorkerJob* rhs) noexcept -> bool { return deadlineOf(lhs) > deadlineOf(rhs); }
+auto Worker::pushDeadline(WorkerJob* job) -> void
+{
+  auto const c = std::size_t(job->prio);
+  auto& heap = mDeadlines[c];
+  heap.push_back(job);
+  std::push_heap(heap.begin(), heap.end(), laterDeadline);
+  mDeadlineCount[c].store(heap.size(), std::memory_order_relaxed);
+}
+auto Worker::pickClass() noexcept -> std::size_t
+{
+  // stride scheduling: the class with the lowest pass runs next and advances its pass by its stride. A class which
+  // was empty rejoins at the current virtual time, so it can't claim the slots it didn't use meanwhile.
+  auto best = kPriorityCount;
+  for (std::size_t i = 0; i < kPriorityCount; i++) {
+    if (mLocalQueues[i].empty() && mOverflowCount[i].load(std::memory_order_relaxed) == 0 && mDeadlines[i].empty()) {
+      continue;
+    }
+    mPass[i] = std::max(mPass[i], mVirtualTime);
+    if (best == kPriorityCount || mPass[i] < mPass[best]) {
+      best = i;
+    }
+  }
+  return best;
+}
+auto Worker::popClass(std::size_t c) -> WorkerJob*
+{
+  if (auto& heap = mDeadlines[c]; !heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), laterDeadline);
+    auto job = heap.back();
+    heap.pop_back();
+    mDeadlineCount[c].store(heap.size(), std::memory_order_relaxed);
+    return job;
+  }
+  auto& overflow = mOverflow[c];
+  auto& overflowCount = mOverflowCount[c];
+  auto job = mLocalQueues[c].pop();
+  if (overflowCount.load(std::memory_order_relaxed) > 0) {
+    // keep the class in fifo order, overflowed jobs are younger than the queued ones
+    auto next = overflow.popFront();
+    overflowCount.store(overflowCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    if (job == nullptr) {
+      job = next;
+    } else {
+      mLocalQueues[c].push(next);
+    }
+  }
+  return job;
+}
+auto Worker::popWeighted() -> WorkerJob*
+{
+  while (true) {
+    auto const best = pickClass();
+    if (best == kPriorityCount) {
+      return nullptr;
+    }
+    auto job = popClass(best);
+    if (job == nullptr) [[unlikely]] { // stolen meanwhile
+      continue;
+    }
+    mVirtualTime = mPass[best];
+    mPass[best] += mStride[best];
+    if (job->shed && deadlineOf(job) < mNow) [[unlikely]] {
+      static_cast<PromiseBase::CoroJob*>(job)->promise->shed();
+      mStats.mShedJobs.add();
+      continue;
+    }
+    // a job stolen from a worker whose clock read is newer than ours counts as not waited
+    auto const waited = mStamp > job->stamp ? mStamp - job->stamp : 0;
+    mStats.mClassRuns[best].add();
+    mStats.mClassWaitUs[best].add(waited);
+    return job;
+  }
+}
+auto Worker::queuedJobs() const noexcept -> std::size_t
+{
+  auto count = std::size_t(0);
+  for (std::size_t i = 0; i < kPriorityCount; i++) {
+    count += mLocalQueues[i].size() + mOverflowCount[i].load(std::memory_order_relaxed) + mDeadlines[i].size();
+  }
+  return count;
+}
+auto Worker::backlog() const noexcept -> std::size_t
 {
-  std::unique_lock lk(mQueueMt, std::try_to_lock);
-  if (!lk.owns_lock()) {
+  auto count = std::size_t(!mInbox.empty());
+  for (std::size_t i = 0; i < kPriorityCount; i++) {
+    count += mLocalQueues[i].size() + mOverflowCount[i].load(std::memory_order_relaxed) +
+             mDeadlineCount[i].load(std::memory_order_relaxed);
+  }
+  return count;
+}
+auto Worker::trySteal() -> bool
+{
+  if (!mExecutor->mOpt.mStealing) {
     return false;
+  }
+  // take the most urgent work first, lower classes are stolen once no victim has anything above them
+  auto const count = mExecutor->mThreadCount;
+  for (std::size_t c = 0; c < kPriorityCount; c++) {
+    for (std::uint32_t i = 1; i < count; i++) {
+      auto& victim = mExecutor->mWorkers[(mTid + i) % count];
+      if (victim->mLocalQueues[c].stealInto(mLocalQueues[c]) > 0) {
+        mStats.mSteals.add();
+        return true;
+      }
+    }
+  }
+  return false;
+}
+auto Worker::spin() -> bool
+{
+  auto const budget = mSpinBudget;
+  auto const spinMax = mSpinMax;
+  if (budget == 0) {
+    return false;
+  }
+  for (std::uint32_t i = 0; i < budget; i++) {
+    auto const found = hasWork() || (i % kSpinPollInterval == 0 && mProactor->ready());
+    if (found) {
+      mProactor->poll(); // completions and timers are only collected by the proactor
+      mStats.mSpinHits.add();
+      mSpinBudget = std::min(spinMax, budget + budget / 2);
+      return true;
+    }
+    if (mState.load(std::memory_order_relaxed) == State::Stop || mRetiring.load(std::memory_order_relaxed))
+        [[unlikely]] {
+      return true;
+    }
+    cpuRelax();
+  }
+  mStats.mSpinMisses.add();
+  // keep a small budget so that a burst can win spinning back
+  mSpinBudget = std::max(std::min(spinMax, kSpinPollInterval), budget / 2);
+  return false;
+}
+auto Worker::hasWork() const noexcept -> bool
+{
+  return mLifoSlot != nullptr || !mPinnedInbox.empty() || !mHighInbox.empty() || !mInbox.empty() ||
+         queuedJobs() > 0;
+}
+auto Worker::park() -> void
+{
+  auto const ready = [this] {
+    return hasWork() || mState.load(std::memory_order_relaxed) == State::Stop ||
+           mRetiring.load(std::memory_order_relaxed);
   };
-  if (opt.mPri == ExeOpt::High) [[unlikely]] {
-    mTaskQueue.pushFront(job);
-  } else {
-    mTaskQueue.pushBack(job);
+  auto const spinMax = mSpinMax;
+  mStats.mParks.add();
+  if (spinMax == 0 && !kStatsEnabled) {
+    mProactor->wait(ready);
+    return;
   }
-  notify();
+  auto const start = std::chrono::steady_clock::now();
+  auto const blocked = mProactor->wait(ready);
+  auto const parked = std::chrono::steady_clock::now() - start;
+  mStats.mParkedUs.add(detail::toMicros(parked));
+  if (spinMax != 0 && blocked && parked < kShortPark) {
+    mSpinBudget = std::min(spinMax, std::max(mSpinBudget * 2, kSpinPollInterval));
+  }
+}
+auto Worker::canPushLocal(ExeOpt opt) const noexcept -> bool
+{
+  return opt.mOpt != ExeOpt::ForceInOne && opt.mPri != ExeOpt::High && tCurrentWorker == this;
+}
+auto Worker::retire() -> bool
+{
+  auto& executor = *mExecutor;
+  mProactor->setForwarding(true);
+  while (true) {
+    forwardJobs();
+    {
+      auto lock = std::scoped_lock(executor.mScaleMt);
+      if (!mRetiring.load(std::memory_order_relaxed)) { // grown back before we were done
+        mProactor->setForwarding(false);
+        return true;
+      }
+      migrateTimers();
+      if (!hasWork() && mProactor->idle()) {
+        // from now on we push to other workers like any other thread, not through our ring
+        tCurrentWorker = nullptr;
+        while (mRingUsers.load(std::memory_order_acquire) != 0) {
+          std::this_thread::yield();
+        }
+        mProactor->releaseRing();
+        mProactor->setForwarding(false);
+        auto state = State::Executing;
+        if (!mState.compare_exchange_strong(state, State::Dormant, std::memory_order_seq_cst)) {
+          return false; // stopped
+        }
+        break;
+      }
+    }
+    // in-flight io isn't moved, wait for it here and pass on what it resumes
+    mProactor->wait([this] { return hasWork() || mState.load(std::memory_order_relaxed) == State::Stop; });
+    if (mState.load(std::memory_order_relaxed) == State::Stop) {
+      return false;
+    }
+  }
+  // pairs with pushInbox(): a job which got in before the state changed is either seen here or wakes dormant()
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!dormant()) {
+    return false;
+  }
+  tCurrentWorker = this;
+  executor.mIdleCount.fetch_add(1, std::memory_order_relaxed);
   return true;
 }
-auto Worker::pushTask(WorkerJobQueue jobs, ExeOpt opt) -> void
+auto Worker::dormant() -> bool
+{
+  while (true) {
+    auto const seq = mDormantSeq.load(std::memory_order_acquire);
+    auto const state = mState.load(std::memory_order_acquire);
+    if (state == State::Stop) {
+      return false;
+    } else if (state == State::Waiting) { // activated, the ring is open again
+      return true;
+    }
+    forwardJobs();
+    mDormantSeq.wait(seq, std::memory_order_acquire);
+  }
+}
+auto Worker::forwardJobs() -> void
 {
-  assert(jobs.back() == nullptr);
-  mQueueMt.lock();
-  if (opt.mPri == ExeOpt::High) [[unlikely]] {
-    mTaskQueue.prepend(std::move(jobs));
+  auto& executor = *mExecutor;
+  if (auto pinned = mPinnedInbox.popAll(); !pinned.empty()) {
+    executor.balanceEnqueue(std::move(pinned), ExeOpt::forceInOne());
+  }
+  if (auto urgent = mHighInbox.popAll(); !urgent.empty()) {
+    executor.balanceEnqueue(std::move(urgent), ExeOpt::balance(ExeOpt::High));
+  }
+  auto jobs = mInbox.popAll();
+  if (auto job = std::exchange(mLifoSlot, nullptr)) {
+    jobs.pushFront(job);
+  }
+  for (std::size_t c = 0; c < kPriorityCount; c++) {
+    while (auto job = popClass(c)) {
+      jobs.pushBack(job);
+    }
+  }
+  if (!jobs.empty()) {
+    executor.balanceEnqueue(std::move(jobs), ExeOpt::balance());
+  }
+}
+auto Worker::migrateTimers() -> void
+{
+  // called under `mScaleMt`, the target is active and started
+  auto& target = *mExecutor->mWorkers[mTid % mExecutor->mActiveCount.load(std::memory_order_relaxed)];
+  if (auto canceled = mProactor->moveTimers(*target.mProactor); !canceled.empty()) {
+    mExecutor->balanceEnqueue(std::move(canceled), ExeOpt::balance());
+  }
+}
+auto Worker::wakeDormant() noexcept -> void
+{
+  mDormantSeq.fetch_add(1, std::memory_order_release);
+  mDormantSeq.notify_one();
+}
+auto Worker::pushBack(WorkerJob* job) -> void
+{
+  if (mExecutor->mOpt.mStealing) {
+    pushLocal(job);
   } else {
-    mTaskQueue.append(std::move(jobs));
+    pushInbox(job, ExeOpt::balance());
+  }
+}
+
+auto Worker::pushLocal(WorkerJob* job) -> void
+{
+  job->stamp = mStamp;
+  if (job->hasDeadline) {
+    pushDeadline(job);
+    mStats.mLocalEnqueues.add();
+    notify();
+    return;
+  }
+  auto& queue = mLocalQueues[std::size_t(job->prio)];
+  if (!queue.push(job)) [[unlikely]] { // local queue overflow
+    mStats.mPushFailures.add();
+    pushInbox(job, ExeOpt::balance());
+    return;
+  }
+  mStats.mLocalEnqueues.add();
+  if (queue.size() > 1) {
+    mExecutor->wakeIdle();
   }
-  mQueueMt.unlock();
   notify();
 }
-auto Worker::tryPushTask(WorkerJobQueue jobs, ExeOpt opt) -> bool
+auto Worker::tryHandOver(WorkerJob* job, ExeOpt opt) -> bool
 {
-  std::unique_lock lk(mQueueMt, std::try_to_lock);
-  if (!lk.owns_lock()) {
+  auto sender = tCurrentWorker;
+  if (sender == nullptr || sender == this || !mExecutor->mOpt.mMsgRing || opt.mOpt == ExeOpt::ForceInOne) {
+    return false;
+  }
+  mRingUsers.fetch_add(1, std::memory_order_seq_cst);
+  auto const handed = !mRetiring.load(std::memory_order_seq_cst) && mProactor->handOver(*sender->mProactor, job);
+  mRingUsers.fetch_sub(1, std::memory_order_release);
+  if (!handed) {
     return false;
   }
-  if (opt.mPri == ExeOpt::High) [[unlikely]] {
-    mTaskQueue.prepend(std::move(jobs));
+  mStats.mUnparks.add();
+  mStats.mHandOvers.add();
+  return true;
+}
+auto Worker::pushInbox(WorkerJob* job, ExeOpt opt) -> void
+{
+  if (tryHandOver(job, opt)) {
+    return;
+  }
+  if (opt.mOpt == ExeOpt::ForceInOne) [[unlikely]] {
+    mPinnedInbox.push(job);
+  } else if (opt.mPri == ExeOpt::High) [[unlikely]] {
+    mHighInbox.push(job);
   } else {
-    mTaskQueue.append(std::move(jobs));
+    mInbox.push(job);
   }
   notify();
-  return true;
+  if (mState.load(std::memory_order_relaxed) == State::Dormant) [[unlikely]] { // went dormant after enqueue()
+    wakeDormant();
+  }
+}
+auto Worker::pushInbox(WorkerJobQueue jobs, ExeOpt opt) -> void
+{
+  if (opt.mOpt == ExeOpt::ForceInOne) [[unlikely]] {
+    mPinnedInbox.push(std::move(jobs));
+  } else if (opt.mPri == ExeOpt::High) [[unlikely]] {
+    mHighInbox.push(std::move(jobs));
+  } else {
+    mInbox.push(std::move(jobs));
+  }
+  notify();
+  if (mState.load(std::memory_order_relaxed) == State::Dormant) [[unlikely]] {
+    wakeDormant();
+  }
+}
+
+auto Worker::pushTask(WorkerJob* job, ExeOpt opt) -> void
+{
+  if (!canPushLocal(opt)) {
+    pushInbox(job, opt);
+    return;
+  }
+  // a job with a deadline waits its turn in the deadline order, the lifo slot would run it ahead of earlier ones
+  if (opt.mOpt == ExeOpt::PreferInOne && mExecutor->mOpt.mLifoSlot && !job->hasDeadline) {
+    // the woken job runs right after the current one, the job it replaces goes to the back of the queue
+    job = std::exchange(mLifoSlot, job);
+    if (job == nullptr) {
+      mStats.mLocalEnqueues.add();
+      notify();
+      return;
+    }
+  }
+  pushBack(job);
+}
+auto Worker::pushTask(WorkerJobQueue jobs, ExeOpt opt) -> void
+{
+  if (!canPushLocal(opt) || !mExecutor->mOpt.mStealing) {
+    pushInbox(std::move(jobs), opt);
+    return;
+  }
+  // a batch wakes at most one idle worker, more join in by stealing from each other
+  auto pushed = std::uint64_t(0);
+  while (auto job = jobs.popFront()) {
+    job->stamp = mStamp;
+    if (job->hasDeadline) {
+      pushDeadline(job);
+      pushed++;
+      continue;
+    }
+    if (!mLocalQueues[std::size_t(job->prio)].push(job)) [[unlikely]] {
+      jobs.pushFront(job);
+      pushInbox(std::move(jobs), ExeOpt::balance());
+      mStats.mPushFailures.add();
+      break;
+    }
+    pushed++;
+  }
+  mStats.mLocalEnqueues.add(pushed);
+  if (queuedJobs() > 1) {
+    mExecutor->wakeIdle();
+  }
 }
 
 // MultiThread executor
 
-MtExecutor::MtExecutor(std::size_t threadCount) : mThreadCount(threadCount)
+MtExecutor::MtExecutor(std::size_t threadCount, MtOpt opt)
+    : mOpt(std::move(opt)), mThreadCount(std::max<std::size_t>(threadCount, mOpt.mMaxThreads)),
+      mActiveCount(threadCount), mTopology(sys::CpuTopology::detect())
 {
-  mWorkers.reserve(threadCount);
-  mThreads.reserve(threadCount);
+  mWorkers.resize(mThreadCount);
+  mThreads.resize(mThreadCount);
+  mPlacement.reserve(mThreadCount);
+  for (std::uint32_t i = 0; i < mThreadCount; i++) {
+    mPlacement.push_back(planPlacement(mOpt, mTopology, i));
+  }
   try {
-    for (int i = 0; i < threadCount; i++) {
-      mWorkers.emplace_back(std::make_unique<Worker>());
+    // spare slots are built here, so that resizing never changes `mWorkers` under a running worker
+    for (std::size_t i = mOpt.mNodeLocal ? threadCount : 0; i < mThreadCount; i++) {
+      mWorkers[i] = std::make_unique<Worker>();
     }
     auto finishLatch = std::latch(threadCount);
-    for (int i = 0; i < threadCount; i++) {
-      mThreads.emplace_back([this, i, &finishLatch] {
-        mWorkers[i]->start(finishLatch);
-        Proactor::get().attachExecutor(this, i);
-        mWorkers[i]->loop();
-      });
+    for (std::uint32_t i = 0; i < threadCount; i++) {
+      startWorker(i, finishLatch);
     }
     finishLatch.wait();
+    mPhase.store(Phase::Running, std::memory_order_release);
+    mPhase.notify_all();
+    if (mOpt.mScaleInterval.count() > 0 && mThreadCount > 1) {
+      mScaler = std::thread([this] { scaleLoop(); });
+    }
   } catch (...) {
     requestStop();
     join();
@@ -138,24 +625,230 @@ MtExecutor::MtExecutor(std::size_t threadCount) : mThreadCount(threadCount)
   }
 }
 
+auto MtExecutor::startWorker(std::uint32_t tid, std::latch& started) -> void
+{
+  mThreads[tid] = std::thread([this, tid, &started] {
+    auto& placement = mPlacement[tid];
+    if (!placement.mCpus.empty()) {
+      placement.mPinned = sys::setThreadAffinity(placement.mCpus) == std::errc{};
+    }
+    if (mWorkers[tid] == nullptr) {
+      mWorkers[tid] = std::make_unique<Worker>();
+    }
+    mWorkers[tid]->start(started, this, tid);
+    Proactor::get().attachExecutor(this, tid);
+    mPhase.wait(Phase::Building, std::memory_order_acquire);
+    mWorkers[tid]->loop();
+    // keep the thread local proactor alive until requestStop() is done notifying it
+    mPhase.wait(Phase::Running, std::memory_order_acquire);
+  });
+}
+
+auto planPlacement(MtOpt const& opt, sys::CpuTopology const& topology, std::uint32_t tid) -> WorkerPlacement
+{
+  auto placement = WorkerPlacement{.mTid = tid};
+  auto const& nodes = topology.mNodes;
+  if (!opt.mCpuSets.empty()) {
+    placement.mCpus = opt.mCpuSets[tid % opt.mCpuSets.size()];
+  } else if (nodes.empty()) {
+    return placement;
+  } else if (opt.mPlacement == MtOpt::Placement::Spread) {
+    auto const& node = nodes[tid % nodes.size()];
+    placement.mCpus = {node[(tid / nodes.size()) % node.size()]};
+  } else if (opt.mPlacement == MtOpt::Placement::Pack) {
+    auto idx = tid % topology.cpuCount();
+    for (auto const& node : nodes) {
+      if (idx < node.size()) {
+        placement.mCpus = {node[idx]};
+        break;
+      }
+      idx -= node.size();
+    }
+  }
+  if (!placement.mCpus.empty()) {
+    placement.mNode = topology.nodeOf(placement.mCpus.front());
+  }
+  return placement;
+}
+
+auto MtExecutor::topologyReport() const -> std::string
+{
+  constexpr std::string_view kPlacement[] = {"none", "spread", "pack"};
+  auto report = std::format("MtExecutor: {} of {} workers active, {} numa nodes, placement {}{}\n", workerCount(),
+                            mThreadCount, mTopology.mNodes.size(), kPlacement[int(mOpt.mPlacement)],
+                            mOpt.mCpuSets.empty() ? "" : " (explicit cpu sets)");
+  for (std::size_t i = 0; i < mTopology.mNodes.size(); i++) {
+    report += std::format("  node {}: {} cpus\n", i, mTopology.mNodes[i].size());
+  }
+  for (auto const& placement : mPlacement) {
+    if (placement.mCpus.empty()) {
+      report += std::format("  worker {}: unpinned\n", placement.mTid);
+      continue;
+    }
+    auto cpus = std::string();
+    for (auto cpu : placement.mCpus) {
+      cpus += (cpus.empty() ? "" : ",") + std::to_string(cpu);
+    }
+    report += std::format("  worker {}: node {}, cpus {}{}\n", placement.mTid, placement.mNode, cpus,
+                          placement.mPinned ? "" : " (pinning failed)");
+  }
+  return report;
+}
+
 auto MtExecutor::requestStop() noexcept -> void
 {
+  {
+    auto lock = std::scoped_lock(mScalerMt);
+    mScalerStop = true;
+  }
+  mScalerCv.notify_all();
+  auto lock = std::scoped_lock(mScaleMt);
   for (auto& worker : mWorkers) {
-    worker->forceStop();
+    if (worker != nullptr) {
+      worker->forceStop();
+    }
   }
+  mPhase.store(Phase::Stopped, std::memory_order_release);
+  mPhase.notify_all();
 }
 
 auto MtExecutor::join() noexcept -> void
 {
+  if (mScaler.joinable()) {
+    mScaler.join();
+  }
   for (auto& thread : mThreads) {
-    thread.join();
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+auto MtExecutor::setWorkerCount(std::size_t count) -> std::size_t
+{
+  auto lock = std::scoped_lock(mScaleMt);
+  if (mPhase.load(std::memory_order_relaxed) == Phase::Stopped) {
+    return workerCount();
+  }
+  count = std::clamp<std::size_t>(count, std::min<std::size_t>(std::max(mOpt.mMinThreads, 1u), mThreadCount),
+                                  mThreadCount);
+  auto const active = mActiveCount.load(std::memory_order_relaxed);
+  if (count == active) {
+    return count;
+  }
+  // grow one worker at a time, so that a failure leaves the count consistent with the workers which made it
+  for (auto i = active; i < count; i++) {
+    activate(i);
+    mActiveCount.store(i + 1, std::memory_order_release);
+  }
+  if (count < active) {
+    // new jobs stop going to the retired workers first, then they hand off what they already have
+    mActiveCount.store(std::uint32_t(count), std::memory_order_release);
+    for (auto i = count; i < active; i++) {
+      mWorkers[i]->mRetiring.store(true, std::memory_order_seq_cst);
+      mWorkers[i]->notify();
+    }
+  }
+  mResizes.fetch_add(1, std::memory_order_relaxed);
+  return count;
+}
+
+auto MtExecutor::activate(std::uint32_t tid) -> void
+{
+  auto& worker = *mWorkers[tid];
+  if (!mThreads[tid].joinable()) {
+    auto started = std::latch(1);
+    startWorker(tid, started);
+    started.wait();
+    return;
+  }
+  if (worker.mState.load(std::memory_order_acquire) != Worker::State::Dormant) {
+    // still handing off, it checks the flag under `mScaleMt` before it goes dormant and keeps running instead
+    worker.mRetiring.store(false, std::memory_order_seq_cst);
+    return;
+  }
+  // the dormant worker doesn't touch its ring, so it can be set up from here and a failure reaches the caller
+  worker.mProactor->acquireRing();
+  worker.mRetiring.store(false, std::memory_order_seq_cst);
+  worker.mState.store(Worker::State::Waiting, std::memory_order_release);
+  worker.wakeDormant();
+}
+
+auto MtExecutor::scaleLoop() -> void
+{
+  auto busyRounds = std::uint32_t(0);
+  auto idleRounds = std::uint32_t(0);
+  auto lock = std::unique_lock(mScalerMt);
+  while (!mScalerCv.wait_for(lock, mOpt.mScaleInterval, [this] { return mScalerStop; })) {
+    auto const active = mActiveCount.load(std::memory_order_acquire);
+    auto parked = std::size_t(0);
+    auto backlog = std::size_t(0);
+    for (std::uint32_t i = 0; i < active; i++) {
+      parked += mWorkers[i]->parked();
+      backlog += mWorkers[i]->backlog();
+    }
+    busyRounds = parked == 0 && backlog > active * kScaleUpBacklog ? busyRounds + 1 : 0;
+    idleRounds = parked * 2 > active ? idleRounds + 1 : 0;
+    try {
+      if (busyRounds >= kScaleUpRounds) {
+        setWorkerCount(active + 1);
+        busyRounds = 0;
+      } else if (idleRounds >= kScaleDownRounds) {
+        setWorkerCount(active - 1);
+        idleRounds = 0;
+      }
+    } catch (std::system_error const&) {
+      // out of threads or rings, try again on the next round
+    }
+  }
+}
+
+auto MtExecutor::wakeIdle() noexcept -> void
+{
+  if (mIdleCount.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  auto const active = mActiveCount.load(std::memory_order_relaxed);
+  for (std::uint32_t i = 0; i < active; i++) {
+    if (mWorkers[i]->parked()) {
+      mWorkers[i]->notify();
+      return;
+    }
+  }
+}
+
+auto MtExecutor::stats() const -> RuntimeStats
+{
+  auto stats = RuntimeStats{};
+  stats.mWorkers.reserve(mWorkers.size());
+  for (auto const& worker : mWorkers) {
+    stats.mWorkers.push_back(worker->mStats.load());
   }
+  return stats;
+}
+auto MtExecutor::queuedByClass() const noexcept -> std::array<std::uint64_t, kPriorityCount>
+{
+  auto queued = std::array<std::uint64_t, kPriorityCount>{};
+  for (auto const& worker : mWorkers) {
+    for (std::size_t i = 0; i < kPriorityCount; i++) {
+      queued[i] += worker->mLocalQueues[i].size() + worker->mOverflowCount[i].load(std::memory_order_relaxed) +
+                   worker->mDeadlineCount[i].load(std::memory_order_relaxed);
+    }
+  }
+  return queued;
 }
 
 auto MtExecutor::execute(WorkerJob* job, ExeOpt opt) noexcept -> void
 {
-  if (opt.mOpt == ExeOpt::PreferInOne) {
-    auto b = mWorkers[opt.mTid]->tryEnqeue(job, opt);
+  if (opt.mOpt == ExeOpt::Target) [[unlikely]] {
+    // pinned like `ForceInOne`, so that it isn't stolen away again
+    auto& target = mWorkers[opt.mTid % mActiveCount.load(std::memory_order_relaxed)];
+    opt = ExeOpt::forceInOne(opt.mPri);
+    if (target->enqueue(job, opt)) {
+      return;
+    }
+  } else if (opt.inCurrent()) {
+    auto b = mWorkers[opt.mTid]->enqueue(job, opt);
     if (b) {
       return;
     }
@@ -164,8 +857,16 @@ auto MtExecutor::execute(WorkerJob* job, ExeOpt opt) noexcept -> void
 }
 auto MtExecutor::execute(WorkerJobQueue&& queue, std::size_t count, ExeOpt opt) noexcept -> void
 {
-  if (opt.mOpt == ExeOpt::PreferInOne) {
-    auto b = mWorkers[opt.mTid]->tryEnqeue(std::move(queue), opt);
+  if (opt.mOpt == ExeOpt::Target) [[unlikely]] {
+    auto& target = mWorkers[opt.mTid % mActiveCount.load(std::memory_order_relaxed)];
+    opt = ExeOpt::forceInOne(opt.mPri);
+    if (target->enqueue(std::move(queue), opt)) {
+      return;
+    }
+    balanceEnqueue(std::move(queue), opt);
+    return;
+  } else if (opt.inCurrent()) {
+    auto b = mWorkers[opt.mTid]->enqueue(std::move(queue), opt);
     if (b) {
       return;
     }
@@ -174,13 +875,32 @@ auto MtExecutor::execute(WorkerJobQueue&& queue, std::size_t count, ExeOpt opt)
   if (count == 0) {
     balanceEnqueue(std::move(queue), opt);
   } else {
+    // round up, so that fewer jobs than workers still go out one per worker instead of degenerating
+    auto const active = mActiveCount.load(std::memory_order_relaxed);
+    auto const perThread = (count + active - 1) / active;
     while (!queue.empty()) {
-      auto const perThread = count / mThreadCount;
       auto perThreadJobs = queue.popFront(perThread);
       balanceEnqueue(std::move(perThreadJobs), opt);
     }
   }
 }
+auto MtExecutor::executeBatches(std::span<WorkerJobQueue> batches, ExeOpt opt) noexcept -> void
+{
+  assert(batches.size() <= mThreadCount);
+  // rotate the first worker, so that a run of small batches doesn't pile up on the low ids. The worker count may have
+  // shrunk since the batches were sized, then some workers take two.
+  auto const start = mNextWorker.fetch_add(1, std::memory_order_relaxed);
+  auto const active = mActiveCount.load(std::memory_order_relaxed);
+  for (std::size_t i = 0; i < batches.size(); i++) {
+    if (batches[i].empty()) {
+      continue;
+    }
+    auto& worker = mWorkers[(start + i) % active];
+    if (!worker->enqueue(std::move(batches[i]), opt)) [[unlikely]] {
+      balanceEnqueue(std::move(batches[i]), opt);
+    }
+  }
+}
 auto MtExecutor::runMain(Task<> task) -> void
 {
   auto& promise = task.promise();
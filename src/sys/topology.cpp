@@ -0,0 +1,117 @@
+#include "coco/sys/topology.hpp"
+
+#include <charconv>
+#include <dirent.h>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+
+namespace coco::sys {
+namespace {
+auto allowedCpus() -> std::vector<int>
+{
+  auto cpus = std::vector<int>();
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (::sched_getaffinity(0, sizeof(set), &set) != 0) {
+    return cpus;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+} // namespace
+
+auto parseCpuList(std::string_view list) -> std::vector<int>
+{
+  auto cpus = std::vector<int>();
+  while (!list.empty()) {
+    auto comma = list.find(',');
+    auto range = list.substr(0, comma);
+    list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+
+    auto first = 0, last = 0;
+    auto begin = range.data(), end = range.data() + range.size();
+    auto [ptr, ec] = std::from_chars(begin, end, first);
+    if (ec != std::errc{}) {
+      continue;
+    }
+    last = first;
+    if (ptr != end && *ptr == '-') {
+      std::from_chars(ptr + 1, end, last);
+    }
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+auto CpuTopology::detect() -> CpuTopology
+{
+  auto allowed = allowedCpus();
+  auto topology = CpuTopology{};
+  auto nodeIds = std::vector<int>();
+  if (auto dir = ::opendir("/sys/devices/system/node"); dir != nullptr) {
+    while (auto entry = ::readdir(dir)) {
+      auto name = std::string_view(entry->d_name);
+      auto id = 0;
+      if (name.starts_with("node") &&
+          std::from_chars(name.data() + 4, name.data() + name.size(), id).ec == std::errc{}) {
+        nodeIds.push_back(id);
+      }
+    }
+    ::closedir(dir);
+  }
+  std::sort(nodeIds.begin(), nodeIds.end());
+  for (auto id : nodeIds) {
+    auto file = std::ifstream("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+    auto line = std::string();
+    std::getline(file, line);
+    auto cpus = parseCpuList(line);
+    std::erase_if(cpus, [&](int cpu) { return !std::binary_search(allowed.begin(), allowed.end(), cpu); });
+    if (!cpus.empty()) {
+      topology.mNodes.push_back(std::move(cpus));
+    }
+  }
+  if (topology.mNodes.empty() && !allowed.empty()) {
+    topology.mNodes.push_back(std::move(allowed));
+  }
+  return topology;
+}
+
+auto CpuTopology::cpuCount() const noexcept -> std::size_t
+{
+  auto count = std::size_t(0);
+  for (auto const& node : mNodes) {
+    count += node.size();
+  }
+  return count;
+}
+
+auto CpuTopology::nodeOf(int cpu) const noexcept -> int
+{
+  for (std::size_t i = 0; i < mNodes.size(); i++) {
+    if (std::find(mNodes[i].begin(), mNodes[i].end(), cpu) != mNodes[i].end()) {
+      return int(i);
+    }
+  }
+  return -1;
+}
+
+auto setThreadAffinity(std::span<int const> cpus) noexcept -> std::errc
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return std::errc(::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set));
+}
+} // namespace coco::sys
\ No newline at end of file
@@ -2,15 +2,20 @@
 #include <mutex>
 
 namespace coco {
-auto TimerManager::addTimer(Instant time, WorkerJob* job) noexcept -> void
+auto TimerManager::addTimer(Instant time, WorkerJob* job, TimerOwner* owner) noexcept -> void
 {
   std::scoped_lock lock(mPendingJobsMt);
-  mPendingJobs.push({time, job, TimerOpKind::Add});
+  mPendingJobs.push(TimerOp{.instant = time, .job = job, .owner = owner, .kind = TimerOpKind::Add});
 }
 auto TimerManager::deleteTimer(void* jobId) noexcept -> void
 {
   std::scoped_lock lock(mPendingJobsMt);
-  mPendingJobs.push(TimerOp{.instant = Instant(), .jobId = jobId, .kind = TimerOpKind::Delete});
+  mPendingJobs.push(TimerOp{.instant = Instant(), .jobId = jobId, .owner = nullptr, .kind = TimerOpKind::Delete});
+}
+auto TimerManager::cancelTimer(WorkerJob* job) -> bool
+{
+  applyPendingOps();
+  return mTimers.eraseIf([job](TimerItem const& timer) { return timer.job == job; });
 }
 auto TimerManager::nextInstant() const noexcept -> Instant
 {
@@ -19,7 +24,26 @@ auto TimerManager::nextInstant() const noexcept -> Instant
   }
   return mTimers.top().instant;
 }
-auto TimerManager::processTimers() -> std::pair<WorkerJobQueue, std::size_t>
+auto TimerManager::empty() -> bool
+{
+  std::scoped_lock lock(mPendingJobsMt);
+  return mPendingJobs.empty() && mTimers.empty();
+}
+auto TimerManager::takeAll() -> std::vector<TimerItem>
+{
+  applyPendingOps();
+  auto timers = std::vector<TimerItem>();
+  auto timer = TimerItem{};
+  while (mTimers.pop(timer)) {
+    if (auto it = mDeleted.find(timer.job->state); it != mDeleted.end()) {
+      mDeleted.erase(it);
+      continue;
+    }
+    timers.push_back(timer);
+  }
+  return timers;
+}
+auto TimerManager::applyPendingOps() -> void
 {
   while (true) {
     TimerOp op{};
@@ -34,14 +58,17 @@ auto TimerManager::processTimers() -> std::pair<WorkerJobQueue, std::size_t>
     }
     switch (op.kind) {
     case TimerOpKind::Add: {
-      mTimers.insert({op.instant, op.job});
+      mTimers.insert({op.instant, op.job, op.owner});
     } break;
     case TimerOpKind::Delete: {
       mDeleted.insert(op.jobId);
     } break;
     }
   }
-
+}
+auto TimerManager::processTimers() -> std::pair<WorkerJobQueue, std::size_t>
+{
+  applyPendingOps();
   WorkerJobQueue jobs;
   std::size_t count = 0;
   auto now = std::chrono::steady_clock::now();
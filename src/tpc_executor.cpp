@@ -0,0 +1,314 @@
+#include "coco/tpc_executor.hpp"
+
+namespace coco {
+static thread_local Core* tCurrentCore = nullptr;
+
+Core::Core(TpcExecutor* executor, std::uint32_t id, std::size_t coreCount) : mExecutor(executor), mId(id)
+{
+  mRings.reserve(coreCount);
+  for (std::size_t i = 0; i < coreCount; i++) {
+    mRings.push_back(std::make_unique<util::SpscRing<WorkerJob, kRingSize>>());
+  }
+}
+Core::~Core() noexcept
+{
+  // jobs still queued at shutdown are dropped, unlink them so the queue's destructor doesn't complain
+  while (mRunQueue.popFront() != nullptr) {
+  }
+  auto inbox = mInbox.popAll();
+  while (inbox.popFront() != nullptr) {
+  }
+}
+auto Core::loop() -> void
+{
+  tCurrentCore = this;
+  while (!mStop.load(std::memory_order_relaxed)) {
+    drain();
+    if (mRunQueue.empty()) {
+      park();
+      continue;
+    }
+    runQueued();
+    mProactor->poll();
+  }
+}
+auto Core::stop() noexcept -> void
+{
+  mStop.store(true, std::memory_order_relaxed);
+  // the loop checks the flag after it is marked as parked, so one notify is enough
+  mProactor->notify();
+}
+auto Core::drain() noexcept -> void
+{
+  auto remote = std::uint64_t(0);
+  for (auto& ring : mRings) {
+    while (auto job = ring->pop()) {
+      mRunQueue.pushBack(job);
+      remote++;
+    }
+  }
+  auto inbox = mInbox.popAll();
+  if constexpr (kStatsEnabled) {
+    for (auto job = inbox.front(); job != nullptr; job = job->next) {
+      remote++;
+    }
+  }
+  mRunQueue.append(std::move(inbox));
+  mStats.mRemoteEnqueues.add(remote);
+}
+auto Core::runQueued() -> void
+{
+  auto const start = kStatsEnabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+  auto runs = std::uint64_t(0);
+  trace(TraceKind::RoundBegin, nullptr);
+  mProactor->refillBudget(mExecutor->mOpt.mBudgetJobs, mExecutor->mOpt.mBudgetTime);
+  while (auto job = mRunQueue.popFront()) {
+    runJob(job, kWorkerArgNull);
+    runs++;
+    if (mProactor->consumeBudget()) [[unlikely]] {
+      break; // back to the loop, which collects remote jobs and polls io before the rest
+    }
+  }
+  mStats.mJobsRun.add(runs);
+  if constexpr (kStatsEnabled) {
+    mStats.mBatchSizes.add(runs);
+    mStats.mBusyUs.add(detail::toMicros(std::chrono::steady_clock::now() - start));
+  }
+  trace(TraceKind::RoundEnd, nullptr, runs);
+}
+auto Core::park() -> void
+{
+  mStats.mParks.add();
+  auto const ready = [this] { return hasWork() || mStop.load(std::memory_order_relaxed); };
+  if constexpr (kStatsEnabled) {
+    auto const start = std::chrono::steady_clock::now();
+    mProactor->wait(ready);
+    mStats.mParkedUs.add(detail::toMicros(std::chrono::steady_clock::now() - start));
+  } else {
+    mProactor->wait(ready);
+  }
+}
+auto Core::hasWork() const noexcept -> bool
+{
+  if (!mRunQueue.empty() || !mInbox.empty()) {
+    return true;
+  }
+  for (auto const& ring : mRings) {
+    if (!ring->empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+auto Core::notify(Core* sender) -> void
+{
+  // a core's ring is polled by its loop, so it can post wakeups for others
+  if (sender != nullptr && mExecutor->mOpt.mMsgRing) {
+    mProactor->notify(*sender->mProactor);
+  } else {
+    mProactor->notify();
+  }
+}
+auto Core::send(WorkerJob* job, Core* sender) noexcept -> void
+{
+  if (sender == nullptr) {
+    mInbox.push(job);
+  } else if (mRings[sender->mId]->push(job)) {
+    sender->mSent.store(sender->mSent.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  } else {
+    mInbox.push(job);
+    sender->mOverflows.store(sender->mOverflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+  notify(sender);
+}
+auto Core::send(WorkerJobQueue jobs, Core* sender) noexcept -> void
+{
+  if (sender != nullptr) {
+    auto& ring = *mRings[sender->mId];
+    auto sent = std::uint64_t(0);
+    while (auto job = jobs.popFront()) {
+      if (!ring.push(job)) {
+        jobs.pushFront(job);
+        sender->mOverflows.store(sender->mOverflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        break;
+      }
+      sent++;
+    }
+    sender->mSent.store(sender->mSent.load(std::memory_order_relaxed) + sent, std::memory_order_relaxed);
+  }
+  mInbox.push(std::move(jobs));
+  notify(sender);
+}
+auto Core::pushLocal(WorkerJob* job, ExeOpt opt) noexcept -> void
+{
+  mStats.mLocalEnqueues.add();
+  if (opt.mPri == ExeOpt::High) [[unlikely]] {
+    mRunQueue.pushFront(job);
+  } else {
+    mRunQueue.pushBack(job);
+  }
+}
+
+// Thread-per-core executor
+
+TpcExecutor::TpcExecutor(std::size_t coreCount, MtOpt opt)
+    : mOpt(std::move(opt)), mTopology(sys::CpuTopology::detect())
+{
+  mCores.resize(coreCount);
+  mThreads.reserve(coreCount);
+  mPlacement.reserve(coreCount);
+  for (std::uint32_t i = 0; i < coreCount; i++) {
+    mPlacement.push_back(planPlacement(mOpt, mTopology, i));
+  }
+  try {
+    auto finishLatch = std::latch(coreCount);
+    for (std::uint32_t i = 0; i < coreCount; i++) {
+      mThreads.emplace_back([this, i, coreCount, &finishLatch] {
+        auto& placement = mPlacement[i];
+        if (!placement.mCpus.empty()) {
+          placement.mPinned = sys::setThreadAffinity(placement.mCpus) == std::errc{};
+        }
+        // built after pinning, so that the run queue and the rings other cores write into are node local
+        mCores[i] = std::make_unique<Core>(this, i, coreCount);
+        mCores[i]->mProactor = &Proactor::get();
+        Tracer::nameThread("core", i);
+        Proactor::get().attachExecutor(this, i);
+        finishLatch.count_down();
+        mPhase.wait(Phase::Building, std::memory_order_acquire);
+        mCores[i]->loop();
+        // keep the thread local proactor alive until requestStop() is done notifying it
+        mPhase.wait(Phase::Running, std::memory_order_acquire);
+      });
+    }
+    finishLatch.wait();
+    mPhase.store(Phase::Running, std::memory_order_release);
+    mPhase.notify_all();
+  } catch (...) {
+    requestStop();
+    join();
+    throw;
+  }
+}
+
+auto TpcExecutor::requestStop() noexcept -> void
+{
+  for (auto& core : mCores) {
+    if (core != nullptr && core->mProactor != nullptr) {
+      core->stop();
+    }
+  }
+  mPhase.store(Phase::Stopped, std::memory_order_release);
+  mPhase.notify_all();
+}
+
+auto TpcExecutor::join() noexcept -> void
+{
+  for (auto& thread : mThreads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+auto TpcExecutor::current() const noexcept -> Core*
+{
+  auto core = tCurrentCore;
+  return core != nullptr && core->mExecutor == this ? core : nullptr;
+}
+
+auto TpcExecutor::sent() const noexcept -> std::uint64_t
+{
+  auto sum = std::uint64_t(0);
+  for (auto const& core : mCores) {
+    sum += core->mSent.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+auto TpcExecutor::overflows() const noexcept -> std::uint64_t
+{
+  auto sum = std::uint64_t(0);
+  for (auto const& core : mCores) {
+    sum += core->mOverflows.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+auto TpcExecutor::stats() const -> RuntimeStats
+{
+  auto stats = RuntimeStats{};
+  stats.mWorkers.reserve(mCores.size());
+  for (auto const& core : mCores) {
+    auto& snapshot = stats.mWorkers.emplace_back(core->mStats.load());
+    snapshot.mPushFailures = core->mOverflows.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+auto TpcExecutor::homeOf(WorkerJob* job, ExeOpt opt, Core* self) noexcept -> std::uint32_t
+{
+  auto home = std::uint32_t(job->home);
+  if (opt.mOpt == ExeOpt::Target) {
+    home = opt.mTid % mCores.size();
+  } else if (home == WorkerJob::kNoHome || home >= mCores.size()) {
+    home = self != nullptr ? self->mId : mNextCore.fetch_add(1, std::memory_order_relaxed) % mCores.size();
+  }
+  if (home < WorkerJob::kNoHome) { // cores past it have no home, their jobs follow whoever wakes them
+    job->home = std::uint8_t(home);
+  }
+  return home;
+}
+auto TpcExecutor::execute(WorkerJob* job, ExeOpt opt) noexcept -> void
+{
+  auto self = current();
+  auto home = homeOf(job, opt, self);
+  if (self != nullptr && self->mId == home) {
+    self->pushLocal(job, opt);
+  } else {
+    mCores[home]->send(job, self);
+  }
+}
+auto TpcExecutor::execute(WorkerJobQueue&& queue, std::size_t /* count */, ExeOpt opt) noexcept -> void
+{
+  auto self = current();
+  if (opt.mOpt == ExeOpt::Target && (self == nullptr || self->mId != opt.mTid % mCores.size())) {
+    for (auto job = queue.front(); job != nullptr; job = job->next) {
+      homeOf(job, opt, self);
+    }
+    mCores[opt.mTid % mCores.size()]->send(std::move(queue), self);
+    return;
+  }
+  while (auto job = queue.popFront()) {
+    execute(job, opt);
+  }
+}
+auto TpcExecutor::executeBatches(std::span<WorkerJobQueue> batches, ExeOpt /* opt */) noexcept -> void
+{
+  assert(batches.size() <= mCores.size());
+  auto self = current();
+  for (std::size_t i = 0; i < batches.size(); i++) {
+    if (batches[i].empty()) {
+      continue;
+    }
+    auto const home = self != nullptr ? self->mId : std::uint32_t(i);
+    for (auto job = batches[i].front(); job != nullptr && home < WorkerJob::kNoHome; job = job->next) {
+      job->home = std::uint8_t(home);
+    }
+    if (self != nullptr) {
+      self->pushLocal(std::move(batches[i]));
+    } else {
+      mCores[i]->send(std::move(batches[i]), nullptr);
+    }
+  }
+}
+auto TpcExecutor::runMain(Task<> task) -> void
+{
+  auto& promise = task.promise();
+  auto taskState = std::atomic<JobState>(JobState::Ready);
+  promise.setState(&taskState);
+  this->execute(promise.getThisJob(), ExeOpt::on(0, ExeOpt::High));
+  while (taskState.load() != JobState::Final) {
+    taskState.wait(JobState::Ready);
+  }
+};
+
+} // namespace coco
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "coco/trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+namespace coco {
+namespace {
+struct Slot {
+  std::atomic_uint64_t mNs;
+  std::atomic_uint64_t mTask;
+  std::atomic_uint64_t mArg;
+  std::atomic<char const*> mName;
+  std::atomic<TraceKind> mKind;
+};
+
+// the event ring of one thread. The writer claims an event in `mWriting` before it overwrites the slot and publishes
+// it in `mHead` after, a reader copies the published events and then drops the ones `mWriting` shows were reused.
+struct TraceBuffer {
+  std::array<Slot, Tracer::kCapacity> mSlots;
+  std::atomic_uint64_t mWriting = 0;
+  std::atomic_uint64_t mHead = 0;
+  std::atomic_uint64_t mFloor = 0; // events before it were cleared
+  std::atomic<char const*> mRole{nullptr};
+  std::atomic_uint32_t mIndex = 0;
+  std::uint32_t mId = 0;
+  std::atomic_bool mOrphaned = false;
+  TraceBuffer* mRegistryNext = nullptr;
+};
+
+// every buffer ever created, buffers are never freed so that a trace can be exported after its threads exited. The
+// buffer of an exited thread is adopted by the next new thread.
+std::atomic<TraceBuffer*> gRegistry{nullptr};
+std::atomic_uint32_t gBufferCount{0};
+thread_local TraceBuffer* tBuffer = nullptr;
+thread_local char const* tRole = nullptr;
+thread_local std::uint32_t tIndex = 0;
+
+auto adopt() -> TraceBuffer*
+{
+  for (auto buffer = gRegistry.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->mRegistryNext) {
+    auto orphaned = true;
+    if (buffer->mOrphaned.compare_exchange_strong(orphaned, false, std::memory_order_acquire)) {
+      return buffer;
+    }
+  }
+  auto buffer = new TraceBuffer();
+  buffer->mId = gBufferCount.fetch_add(1, std::memory_order_relaxed);
+  auto head = gRegistry.load(std::memory_order_relaxed);
+  do {
+    buffer->mRegistryNext = head;
+  } while (!gRegistry.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+  return buffer;
+}
+
+auto local() -> TraceBuffer&
+{
+  struct Holder {
+    ~Holder()
+    {
+      if (tBuffer != nullptr) {
+        tBuffer->mOrphaned.store(true, std::memory_order_release);
+        tBuffer = nullptr;
+      }
+    }
+  };
+  thread_local Holder holder;
+  if (tBuffer == nullptr) [[unlikely]] {
+    (void)&holder;
+    tBuffer = adopt();
+    tBuffer->mRole.store(tRole, std::memory_order_relaxed);
+    tBuffer->mIndex.store(tIndex, std::memory_order_relaxed);
+  }
+  return *tBuffer;
+}
+
+auto copyEvents(TraceBuffer const& buffer, std::vector<TraceEvent>& out) -> void
+{
+  auto const head = buffer.mHead.load(std::memory_order_acquire);
+  auto const floor = buffer.mFloor.load(std::memory_order_relaxed);
+  auto const begin = std::max(floor, head > Tracer::kCapacity ? head - Tracer::kCapacity : 0);
+  auto const first = out.size();
+  for (auto i = begin; i < head; i++) {
+    auto const& slot = buffer.mSlots[i % Tracer::kCapacity];
+    out.push_back(TraceEvent{
+        .mNs = slot.mNs.load(std::memory_order_relaxed),
+        .mTask = slot.mTask.load(std::memory_order_relaxed),
+        .mArg = slot.mArg.load(std::memory_order_relaxed),
+        .mName = slot.mName.load(std::memory_order_relaxed),
+        .mKind = slot.mKind.load(std::memory_order_relaxed),
+        .mThread = buffer.mId,
+    });
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // slots of events older than this may have been overwritten while they were copied
+  auto const writing = buffer.mWriting.load(std::memory_order_relaxed);
+  auto const valid = writing > Tracer::kCapacity ? writing - Tracer::kCapacity : 0;
+  if (valid > begin) {
+    auto const stale = std::min(valid - begin, head - begin);
+    out.erase(out.begin() + std::ptrdiff_t(first), out.begin() + std::ptrdiff_t(first + stale));
+  }
+}
+
+// the `T` of `traceName<T>()`, parsed from the function signature gcc and clang put in `__PRETTY_FUNCTION__`
+auto awaitableName(char const* pretty) -> std::string_view
+{
+  auto name = std::string_view(pretty);
+  auto const begin = name.find("T = ");
+  if (begin == std::string_view::npos) {
+    return name;
+  }
+  name.remove_prefix(begin + 4);
+  auto end = name.find(';');
+  if (end == std::string_view::npos) {
+    end = name.rfind(']');
+  }
+  return name.substr(0, end);
+}
+
+auto appendEscaped(std::string& out, std::string_view text) -> void
+{
+  for (auto c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+}
+} // namespace
+
+auto Tracer::start() noexcept -> void { detail::gTracing.store(true, std::memory_order_relaxed); }
+auto Tracer::stop() noexcept -> void { detail::gTracing.store(false, std::memory_order_relaxed); }
+
+auto Tracer::clear() noexcept -> void
+{
+  for (auto buffer = gRegistry.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->mRegistryNext) {
+    buffer->mFloor.store(buffer->mHead.load(std::memory_order_acquire), std::memory_order_relaxed);
+  }
+}
+
+auto Tracer::nameThread(char const* role, std::uint32_t index) noexcept -> void
+{
+  tRole = role;
+  tIndex = index;
+  if (tBuffer != nullptr) {
+    tBuffer->mRole.store(role, std::memory_order_relaxed);
+    tBuffer->mIndex.store(index, std::memory_order_relaxed);
+  }
+}
+
+auto Tracer::record(TraceKind kind, void const* task, std::uint64_t arg, char const* name) noexcept -> void
+{
+  auto& buffer = local();
+  auto const n = buffer.mWriting.load(std::memory_order_relaxed);
+  buffer.mWriting.store(n + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  auto& slot = buffer.mSlots[n % kCapacity];
+  auto const now = std::chrono::steady_clock::now().time_since_epoch();
+  slot.mNs.store(std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()),
+                 std::memory_order_relaxed);
+  slot.mTask.store(reinterpret_cast<std::uintptr_t>(task), std::memory_order_relaxed);
+  slot.mArg.store(arg, std::memory_order_relaxed);
+  slot.mName.store(name, std::memory_order_relaxed);
+  slot.mKind.store(kind, std::memory_order_relaxed);
+  buffer.mHead.store(n + 1, std::memory_order_release);
+}
+
+auto Tracer::snapshot() -> std::vector<TraceEvent>
+{
+  auto events = std::vector<TraceEvent>();
+  for (auto buffer = gRegistry.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->mRegistryNext) {
+    copyEvents(*buffer, events);
+  }
+  return events;
+}
+
+auto Tracer::exportChrome() -> std::string
+{
+  auto const events = snapshot();
+  auto base = ~std::uint64_t(0);
+  for (auto const& event : events) {
+    base = std::min(base, event.mNs);
+  }
+  auto out = std::string("{\"traceEvents\":[\n");
+  auto line = std::array<char, 256>();
+  auto const append = [&](char const* format, auto... args) {
+    if (out.back() != '\n') {
+      out += ",\n";
+    }
+    auto const length = std::snprintf(line.data(), line.size(), format, args...);
+    out.append(line.data(), std::min(std::size_t(std::max(length, 0)), line.size() - 1));
+  };
+  for (auto buffer = gRegistry.load(std::memory_order_acquire); buffer != nullptr; buffer = buffer->mRegistryNext) {
+    auto const role = buffer->mRole.load(std::memory_order_relaxed);
+    auto const index = role != nullptr ? buffer->mIndex.load(std::memory_order_relaxed) : buffer->mId;
+    append(R"({"name":"thread_name","ph":"M","pid":1,"tid":%u,"args":{"name":"%s %u"}})", buffer->mId,
+           role != nullptr ? role : "thread", index);
+  }
+  for (auto const& event : events) {
+    auto const ts = double(event.mNs - base) / 1000.0;
+    auto const task = static_cast<unsigned long long>(event.mTask);
+    auto const tid = event.mThread;
+    switch (event.mKind) {
+    case TraceKind::Spawn:
+    case TraceKind::Complete:
+      // an async span per task, so that its whole life shows on its own track
+      append(R"({"name":"task","cat":"task","ph":"%s","id":"0x%llx","ts":%.3f,"pid":1,"tid":%u})",
+             event.mKind == TraceKind::Spawn ? "b" : "e", task, ts, tid);
+      break;
+    case TraceKind::Run:
+      append(R"({"name":"run","ph":"B","ts":%.3f,"pid":1,"tid":%u,"args":{"task":"0x%llx"}})", ts, tid, task);
+      break;
+    case TraceKind::Suspend:
+      append(R"({"ph":"E","ts":%.3f,"pid":1,"tid":%u})", ts, tid);
+      break;
+    case TraceKind::Await:
+      // type names can be longer than a line, so the name goes in separately
+      append(R"({"ph":"i","s":"t","ts":%.3f,"pid":1,"tid":%u,"args":{"task":"0x%llx"},"name":"await )", ts, tid,
+             task);
+      appendEscaped(out, event.mName != nullptr ? awaitableName(event.mName) : "?");
+      out += "\"}";
+      break;
+    case TraceKind::Io:
+      append(R"({"name":"io","ph":"i","s":"t","ts":%.3f,"pid":1,"tid":%u,"args":{"task":"0x%llx","res":%d}})", ts,
+             tid, task, int(std::int32_t(event.mArg)));
+      break;
+    case TraceKind::RoundBegin:
+      append(R"({"name":"round","ph":"B","ts":%.3f,"pid":1,"tid":%u})", ts, tid);
+      break;
+    case TraceKind::RoundEnd:
+      append(R"({"ph":"E","ts":%.3f,"pid":1,"tid":%u,"args":{"queued":%llu}})", ts, tid,
+             static_cast<unsigned long long>(event.mArg));
+      break;
+    }
+  }
+  out += "\n]}\n";
+  return out;
+}
+} // namespace coco
\ No newline at end of file
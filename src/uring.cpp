@@ -3,25 +3,53 @@
 namespace coco {
 IoUring::IoUring()
 {
-  if (auto r = ::io_uring_queue_init(kIoUringQueueSize, &mUring, 0); r != 0) {
-    throw std::system_error(-r, std::system_category(), "create uring instance failed");
-  }
   mEventFd = ::eventfd(0, 0);
   if (mEventFd < 0) {
     throw std::system_error(errno, std::system_category(), "create eventfd failed");
   }
+  try {
+    open();
+  } catch (...) {
+    ::close(mEventFd);
+    throw;
+  }
+}
+IoUring::~IoUring()
+{
+  close();
+  ::close(mEventFd);
+}
+auto IoUring::open() -> void
+{
+  if (mOpen) {
+    return;
+  }
+  if (auto r = ::io_uring_queue_init(kIoUringQueueSize, &mUring, 0); r != 0) {
+    throw std::system_error(-r, std::system_category(), "create uring instance failed");
+  }
+  if (auto probe = ::io_uring_get_probe_ring(&mUring); probe != nullptr) {
+    mMsgRing = ::io_uring_opcode_supported(probe, IORING_OP_MSG_RING);
+    ::io_uring_free_probe(probe);
+  }
+  mFileTable = ::io_uring_register_files_sparse(&mUring, kFileTableSize) == 0;
   auto sqe = fetchSqe();
   ::io_uring_prep_poll_multishot(sqe, mEventFd, POLLIN);
   ::io_uring_sqe_set_data(sqe, nullptr);
   ::io_uring_submit(&mUring);
+  mOpen = true;
 }
-IoUring::~IoUring()
+auto IoUring::close() noexcept -> void
 {
+  if (!mOpen) {
+    return;
+  }
   auto sqe = fetchSqe();
   ::io_uring_prep_poll_remove(sqe, 0);
   ::io_uring_submit_and_wait(&mUring, 1);
-  ::close(mEventFd);
   ::io_uring_queue_exit(&mUring);
+  mOpen = false;
+  mMsgRing = false;
+  mFileTable = false;
 }
 auto IoUring::prepRecv(Token token, int fd, std::span<std::byte> buf, int flag) noexcept -> void
 {
@@ -35,6 +63,22 @@ auto IoUring::prepSend(Token token, int fd, std::span<std::byte const> buf, int
   ::io_uring_prep_send(sqe, fd, (void const*)buf.data(), buf.size(), flag);
   ::io_uring_sqe_set_data(sqe, token);
 }
+auto IoUring::prepRecvSelect(Token token, int fd, std::uint16_t group) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_recv(sqe, fd, nullptr, 0, 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = group;
+  ::io_uring_sqe_set_data(sqe, token);
+}
+auto IoUring::prepRecvMultishot(Token token, int fd, std::uint16_t group) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_recv_multishot(sqe, fd, nullptr, 0, 0);
+  sqe->flags |= IOSQE_BUFFER_SELECT;
+  sqe->buf_group = group;
+  ::io_uring_sqe_set_data(sqe, token);
+}
 auto IoUring::prepRecvMsg(Token token, int fd, msghdr* msg, unsigned flag) noexcept -> void
 {
   auto sqe = fetchSqe();
@@ -65,6 +109,30 @@ auto IoUring::prepConnect(Token token, int fd, sockaddr* addr, socklen_t addrlen
   ::io_uring_prep_connect(sqe, fd, addr, addrlen);
   ::io_uring_sqe_set_data(sqe, token);
 }
+auto IoUring::prepAcceptDirect(Token token, int fd) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_accept_direct(sqe, fd, nullptr, nullptr, 0, IORING_FILE_INDEX_ALLOC);
+  ::io_uring_sqe_set_data(sqe, token);
+}
+auto IoUring::prepAcceptMtDirect(Token token, int fd) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_multishot_accept_direct(sqe, fd, nullptr, nullptr, 0);
+  ::io_uring_sqe_set_data(sqe, token);
+}
+auto IoUring::prepOpenAt(Token token, char const* path, int flags, mode_t mode) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_openat(sqe, AT_FDCWD, path, flags, mode);
+  ::io_uring_sqe_set_data(sqe, token);
+}
+auto IoUring::prepOpenAtDirect(Token token, char const* path, int flags, mode_t mode) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_openat_direct(sqe, AT_FDCWD, path, flags, mode, IORING_FILE_INDEX_ALLOC);
+  ::io_uring_sqe_set_data(sqe, token);
+}
 auto IoUring::seen(io_uring_cqe* cqe) noexcept -> void { ::io_uring_cqe_seen(&mUring, cqe); }
 auto IoUring::submitWait(int waitn) noexcept -> std::errc
 {
@@ -85,12 +153,30 @@ auto IoUring::prepCancel(Token token) noexcept -> void
   ::io_uring_prep_cancel(sqe, token, 0);
   ::io_uring_sqe_set_data(sqe, token);
 }
+auto IoUring::prepAsyncCancel(Token target) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_cancel(sqe, target, 0);
+  ::io_uring_sqe_set_data(sqe, nullptr);
+}
+auto IoUring::prepTimeout(Token token, __kernel_timespec* spec) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_timeout(sqe, spec, 0, 0);
+  ::io_uring_sqe_set_data(sqe, token);
+}
 auto IoUring::prepClose(Token token, int fd) noexcept -> void
 {
   auto sqe = fetchSqe();
   ::io_uring_prep_close(sqe, fd);
   ::io_uring_sqe_set_data(sqe, token);
 }
+auto IoUring::prepCloseDirect(Token token, int slot) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_close_direct(sqe, slot);
+  ::io_uring_sqe_set_data(sqe, token);
+}
 auto IoUring::prepRead(Token token, int fd, std::span<std::byte> buf, off_t offset) noexcept -> void
 {
   auto sqe = fetchSqe();
@@ -103,18 +189,60 @@ auto IoUring::prepWrite(Token token, int fd, std::span<std::byte const> buf, off
   ::io_uring_prep_write(sqe, fd, (void const*)buf.data(), buf.size(), offset);
   ::io_uring_sqe_set_data(sqe, token);
 }
+auto IoUring::prepReadFixed(Token token, int fd, std::span<std::byte> buf, off_t offset, int index) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_read_fixed(sqe, fd, (void*)buf.data(), buf.size(), offset, index);
+  ::io_uring_sqe_set_data(sqe, token);
+}
+auto IoUring::prepWriteFixed(Token token, int fd, std::span<std::byte const> buf, off_t offset, int index) noexcept
+    -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_write_fixed(sqe, fd, (void const*)buf.data(), buf.size(), offset, index);
+  ::io_uring_sqe_set_data(sqe, token);
+}
+auto IoUring::prepSendZcFixed(Token token, int fd, std::span<std::byte const> buf, int index) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_send_zc_fixed(sqe, fd, (void const*)buf.data(), buf.size(), MSG_NOSIGNAL, 0, index);
+  ::io_uring_sqe_set_data(sqe, token);
+}
+auto IoUring::registerBuffers(std::span<::iovec const> iovecs) noexcept -> std::errc
+{
+  auto r = ::io_uring_register_buffers(&mUring, iovecs.data(), iovecs.size());
+  return r < 0 ? std::errc(-r) : std::errc(0);
+}
+auto IoUring::registerBufRing(::io_uring_buf_ring* ring, std::uint32_t entries, std::uint16_t group) noexcept
+    -> std::errc
+{
+  auto reg = ::io_uring_buf_reg{};
+  reg.ring_addr = reinterpret_cast<std::uint64_t>(ring);
+  reg.ring_entries = entries;
+  reg.bgid = group;
+  auto r = ::io_uring_register_buf_ring(&mUring, &reg, 0);
+  return r < 0 ? std::errc(-r) : std::errc(0);
+}
 auto IoUring::notify() noexcept -> void
 {
   auto buf = std::uint64_t(0);
   auto r = ::write(mEventFd, &buf, sizeof(buf));
   assert(r);
 }
+auto IoUring::prepMsgRing(Token token, int targetFd, std::uint64_t data) noexcept -> void
+{
+  auto sqe = fetchSqe();
+  ::io_uring_prep_msg_ring(sqe, targetFd, 0, data, 0);
+  ::io_uring_sqe_set_data(sqe, token);
+  sqe->flags |= IOSQE_CQE_SKIP_SUCCESS;
+}
 auto IoUring::fetchSqe() -> io_uring_sqe*
 {
   auto sqe = ::io_uring_get_sqe(&mUring);
   if (sqe == nullptr) [[unlikely]] {
     throw std::runtime_error("sqe full"); // TODO: better without exception.
   }
+  mLastSqe = sqe;
   return sqe;
 }
 auto IoUring::advance(std::uint32_t n) noexcept -> void { ::io_uring_cq_advance(&mUring, n); }
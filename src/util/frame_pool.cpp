@@ -0,0 +1,195 @@
+#include "coco/util/frame_pool.hpp"
+
+#include <new>
+
+namespace coco::util {
+namespace {
+// every pool ever created, pools are never freed since frames of an exited thread may still be in flight
+std::atomic<FramePool*> gRegistry{nullptr};
+thread_local FramePool* tPool = nullptr;
+thread_local bool tExited = false;
+} // namespace
+
+auto FramePool::local() -> FramePool&
+{
+  struct Holder {
+    ~Holder()
+    {
+      if (tPool != nullptr) {
+        tPool->release();
+        tPool = nullptr;
+      }
+      tExited = true;
+    }
+  };
+  thread_local Holder holder;
+  if (tPool == nullptr) [[unlikely]] {
+    (void)&holder;
+    tPool = adopt();
+  }
+  return *tPool;
+}
+
+auto FramePool::adopt() -> FramePool*
+{
+  for (auto pool = gRegistry.load(std::memory_order_acquire); pool != nullptr; pool = pool->mRegistryNext) {
+    auto orphaned = true;
+    if (pool->mOrphaned.compare_exchange_strong(orphaned, false, std::memory_order_acquire)) {
+      pool->reclaim();
+      return pool;
+    }
+  }
+  auto pool = new FramePool();
+  auto head = gRegistry.load(std::memory_order_relaxed);
+  do {
+    pool->mRegistryNext = head;
+  } while (!gRegistry.compare_exchange_weak(head, pool, std::memory_order_release, std::memory_order_relaxed));
+  return pool;
+}
+
+auto FramePool::release() noexcept -> void
+{
+  for (auto& batch : mRemote) {
+    flush(batch);
+  }
+  reclaim();
+  for (auto& list : mFree) {
+    while (list.mHead != nullptr) {
+      auto frame = list.mHead;
+      list.mHead = frame->mNext;
+      ::operator delete(reinterpret_cast<Header*>(frame) - 1);
+    }
+    list.mCount = 0;
+  }
+  mRetainedBytes.store(0, std::memory_order_relaxed);
+  mOrphaned.store(true, std::memory_order_release);
+}
+
+auto FramePool::allocate(std::size_t size) -> void*
+{
+  auto const cls = (size + sizeof(Header) - 1) / kGranularity;
+  if (cls >= kClassCount || tExited) [[unlikely]] {
+    auto header = static_cast<Header*>(::operator new(size + sizeof(Header)));
+    header->mOwner = nullptr;
+    return header + 1;
+  }
+  auto& pool = local();
+  auto& list = pool.mFree[cls];
+  pool.addCounter(pool.mAllocs, 1);
+  if (list.mHead == nullptr) {
+    pool.reclaim();
+  }
+  if (auto frame = list.mHead; frame != nullptr) {
+    list.mHead = frame->mNext;
+    list.mCount--;
+    pool.addCounter(pool.mHits, 1);
+    pool.addCounter(pool.mRetainedBytes, -std::int64_t((cls + 1) * kGranularity));
+    return frame;
+  }
+  auto header = static_cast<Header*>(::operator new((cls + 1) * kGranularity));
+  header->mOwner = &pool;
+  header->mClass = std::uint32_t(cls);
+  return header + 1;
+}
+
+auto FramePool::deallocate(void* ptr, std::size_t) noexcept -> void
+{
+  auto header = static_cast<Header*>(ptr) - 1;
+  auto owner = header->mOwner;
+  if (owner == nullptr) {
+    ::operator delete(header);
+    return;
+  }
+  auto frame = ::new (ptr) FreeFrame{nullptr};
+  if (owner == tPool) {
+    auto& list = owner->mFree[header->mClass];
+    if (list.mCount >= kMaxCached) {
+      ::operator delete(header);
+      return;
+    }
+    frame->mNext = list.mHead;
+    list.mHead = frame;
+    list.mCount++;
+    owner->addCounter(owner->mRetainedBytes, std::int64_t((header->mClass + 1) * kGranularity));
+  } else if (tExited) [[unlikely]] {
+    auto batch = RemoteBatch{owner, frame, frame, 1};
+    flush(batch);
+  } else {
+    local().freeRemote(frame, owner);
+  }
+}
+
+auto FramePool::stats() noexcept -> FramePoolStats
+{
+  auto stats = FramePoolStats{};
+  for (auto pool = gRegistry.load(std::memory_order_acquire); pool != nullptr; pool = pool->mRegistryNext) {
+    stats.mAllocs += pool->mAllocs.load(std::memory_order_relaxed);
+    stats.mHits += pool->mHits.load(std::memory_order_relaxed);
+    stats.mRetainedBytes += pool->mRetainedBytes.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+auto FramePool::reclaim() noexcept -> void
+{
+  if (mRemoteFree.load(std::memory_order_relaxed) == nullptr) {
+    return;
+  }
+  auto frame = mRemoteFree.exchange(nullptr, std::memory_order_acquire);
+  auto retained = std::int64_t(0);
+  while (frame != nullptr) {
+    auto next = frame->mNext;
+    auto header = reinterpret_cast<Header*>(frame) - 1;
+    auto& list = mFree[header->mClass];
+    if (list.mCount >= kMaxCached) {
+      ::operator delete(header);
+    } else {
+      frame->mNext = list.mHead;
+      list.mHead = frame;
+      list.mCount++;
+      retained += std::int64_t((header->mClass + 1) * kGranularity);
+    }
+    frame = next;
+  }
+  addCounter(mRetainedBytes, retained);
+}
+
+auto FramePool::freeRemote(FreeFrame* frame, FramePool* owner) noexcept -> void
+{
+  auto batch = &mRemote[0];
+  for (auto& slot : mRemote) {
+    if (slot.mOwner == owner) {
+      batch = &slot;
+      break;
+    }
+  }
+  if (batch->mOwner != owner) {
+    batch = &mRemote[mNextRemoteSlot++ % kRemoteSlots];
+    flush(*batch);
+    batch->mOwner = owner;
+  }
+  frame->mNext = batch->mHead;
+  batch->mHead = frame;
+  if (batch->mTail == nullptr) {
+    batch->mTail = frame;
+  }
+  if (++batch->mCount >= kRemoteBatch) {
+    flush(*batch);
+  }
+}
+
+auto FramePool::flush(RemoteBatch& batch) noexcept -> void
+{
+  if (batch.mCount == 0) {
+    return;
+  }
+  auto& stack = batch.mOwner->mRemoteFree;
+  auto head = stack.load(std::memory_order_relaxed);
+  do {
+    batch.mTail->mNext = head;
+  } while (!stack.compare_exchange_weak(head, batch.mHead, std::memory_order_release, std::memory_order_relaxed));
+  batch.mHead = nullptr;
+  batch.mTail = nullptr;
+  batch.mCount = 0;
+}
+} // namespace coco::util
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "coco/net.hpp"
+#include "coco/runtime.hpp"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr std::uint16_t kPort = 23471;
+
+// blocking connects from outside the runtime, each client sends its index and closes
+auto connectClients(int count) -> std::jthread
+{
+  return std::jthread([count] {
+    auto addr = ::sockaddr_in{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < count; i++) {
+      auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+      ASSERT_GE(fd, 0);
+      ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+      ASSERT_EQ(::write(fd, &i, sizeof(i)), ssize_t(sizeof(i)));
+      ::close(fd);
+    }
+  });
+}
+} // namespace
+
+TEST(AcceptStream, AcceptsEveryConnection)
+{
+  using namespace coco::sys;
+  auto [listener, errc] = TcpListener::bind(SocketAddr(SocketAddrV4::loopback(kPort)));
+  ASSERT_EQ(errc, std::errc(0));
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto seen = std::vector<bool>(100, false);
+  auto clients = connectClients(int(seen.size()));
+  rt.block([](TcpListener& listener, std::vector<bool>& seen) -> coco::Task<> {
+    auto connections = listener.acceptStream();
+    for (std::size_t n = 0; n < seen.size(); n++) {
+      auto [stream, errc] = co_await connections.next();
+      if (errc != std::errc(0)) {
+        co_return;
+      }
+      auto index = 0;
+      auto [len, errc2] = co_await stream.recv(std::as_writable_bytes(std::span(&index, 1)));
+      if (errc2 == std::errc(0) && len == sizeof(index) && index >= 0 && index < int(seen.size())) {
+        seen[index] = true;
+      }
+    }
+  }(listener, seen));
+  clients.join();
+  for (std::size_t i = 0; i < seen.size(); i++) {
+    EXPECT_TRUE(seen[i]) << i;
+  }
+}
+
+TEST(AcceptStream, SlowConsumerLosesNoConnection)
+{
+  using namespace coco::sys;
+  using namespace std::chrono_literals;
+  auto [listener, errc] = TcpListener::bind(SocketAddr(SocketAddrV4::loopback(kPort + 1)));
+  ASSERT_EQ(errc, std::errc(0));
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto accepted = 0;
+  rt.block([](coco::Runtime& rt, TcpListener& listener, int& accepted) -> coco::Task<> {
+    // the stream stops accepting after 2 connections until the consumer drains them
+    auto connections = listener.acceptStream(2);
+    auto clients = std::jthread([] {
+      auto addr = ::sockaddr_in{};
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(kPort + 1);
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      auto fds = std::vector<int>();
+      for (int i = 0; i < 20; i++) {
+        auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+          fds.push_back(fd);
+        }
+      }
+      std::this_thread::sleep_for(200ms);
+      for (auto fd : fds) {
+        ::close(fd);
+      }
+    });
+    for (int i = 0; i < 20; i++) {
+      auto [stream, errc] = co_await connections.next();
+      if (errc != std::errc(0)) {
+        co_return;
+      }
+      accepted++;
+      if (i == 0) {
+        co_await rt.sleepFor(50ms); // the others pile up in the backlog meanwhile
+      }
+    }
+  }(rt, listener, accepted));
+  EXPECT_EQ(accepted, 20);
+}
\ No newline at end of file
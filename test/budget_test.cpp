@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+#include "coco/sync/latch.hpp"
+#include "coco/sys/file.hpp"
+
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr int kFlood = 100'000;
+
+auto busyTask(std::atomic_int& done, coco::sync::Latch& latch) -> coco::Task<>
+{
+  auto const start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start < 2us) {
+  }
+  done.fetch_add(1);
+  latch.countDown();
+  co_return;
+}
+
+// the flood jobs done when the sleep, or the read, completed
+auto sleeper(coco::Runtime& rt, std::atomic_int& done, int& seen) -> coco::Task<>
+{
+  co_await rt.sleepFor(5ms);
+  seen = done.load();
+}
+
+auto reader(coco::sys::File& pipe, std::atomic_int& done, int& seen) -> coco::Task<>
+{
+  auto byte = std::byte();
+  auto [n, errc] = co_await pipe.read({&byte, 1}, -1);
+  EXPECT_EQ(n, 1);
+  EXPECT_EQ(errc, std::errc(0));
+  seen = done.load();
+}
+} // namespace
+
+TEST(Budget, ExhaustedWorkerStillPollsTimersAndIo)
+{
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+  auto readEnd = coco::sys::File(fds[0]);
+  auto writeEnd = coco::sys::File(fds[1]);
+  // one worker, so the sleep and the read only complete if it polls in the middle of the flood
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto done = std::atomic_int(0);
+  auto timerSeen = -1;
+  auto ioSeen = -1;
+  auto writer = std::thread();
+  rt.block([](coco::Runtime& rt, coco::sys::File& pipe, int writeFd, std::thread& writer, std::atomic_int& done,
+              int& timerSeen, int& ioSeen) -> coco::Task<> {
+    auto sleep = rt.spawn(sleeper(rt, done, timerSeen));
+    auto read = rt.spawn(reader(pipe, done, ioSeen));
+    co_await rt.sleepFor(1ms); // both are waiting now
+    writer = std::thread([writeFd] {
+      std::this_thread::sleep_for(5ms);
+      auto byte = char(1);
+      EXPECT_EQ(::write(writeFd, &byte, 1), 1);
+    });
+    auto latch = coco::sync::Latch(kFlood);
+    for (int i = 0; i < kFlood; i++) {
+      rt.spawnDetach(busyTask(done, latch));
+    }
+    co_await latch.wait();
+    co_await sleep.join();
+    co_await read.join();
+  }(rt, readEnd, fds[1], writer, done, timerSeen, ioSeen));
+  writer.join();
+  // the flood takes hundreds of milliseconds, both complete a budget window after they are due
+  EXPECT_GE(timerSeen, 0);
+  EXPECT_LT(timerSeen, kFlood / 2);
+  EXPECT_GE(ioSeen, 0);
+  EXPECT_LT(ioSeen, kFlood / 2);
+  auto stats = rt.stats();
+  if (stats.mEnabled) {
+    EXPECT_GT(stats.total().mBudgetPolls, 0);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include "coco/buffer_pool.hpp"
+
+#include <thread>
+#include <vector>
+
+TEST(BufferPool, LeaseUntilExhausted)
+{
+  auto pool = std::make_shared<coco::BufferPool>(4, 1000);
+  ASSERT_EQ(pool->bufferSize(), 4096);
+  auto buffers = std::vector<coco::FixedBuffer>();
+  for (int i = 0; i < 4; i++) {
+    auto buf = pool->lease();
+    ASSERT_TRUE(buf);
+    ASSERT_EQ(buf.capacity(), 4096);
+    ASSERT_EQ(buf.size(), 0);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(buf.data()) % 4096, 0);
+    buffers.push_back(std::move(buf));
+  }
+  ASSERT_FALSE(pool->lease());
+
+  auto stats = pool->stats();
+  EXPECT_EQ(stats.mCapacity, 4);
+  EXPECT_EQ(stats.mInUse, 4);
+  EXPECT_EQ(stats.mHighWater, 4);
+  EXPECT_EQ(stats.mLeases, 4);
+  EXPECT_EQ(stats.mExhausted, 1);
+
+  buffers.pop_back();
+  buffers.pop_back();
+  stats = pool->stats();
+  EXPECT_EQ(stats.mInUse, 2);
+  EXPECT_EQ(stats.mHighWater, 4);
+}
+
+TEST(BufferPool, MovedBufferIsReturnedOnce)
+{
+  auto pool = std::make_shared<coco::BufferPool>(2, 4096);
+  auto a = pool->lease();
+  a.resize(10000);
+  ASSERT_EQ(a.size(), 4096);
+  auto b = std::move(a);
+  ASSERT_FALSE(a);
+  ASSERT_TRUE(b);
+  auto c = pool->lease();
+  c = std::move(b); // c's own buffer goes back
+  ASSERT_EQ(pool->stats().mInUse, 1);
+  c.release();
+  ASSERT_EQ(pool->stats().mInUse, 0);
+}
+
+TEST(BufferPool, ReturnedFromOtherThreads)
+{
+  auto pool = std::make_shared<coco::BufferPool>(64, 4096);
+  auto threads = std::vector<std::jthread>();
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&pool] {
+      for (int i = 0; i < 10000; i++) {
+        auto buf = pool->lease();
+        if (buf) {
+          buf.data()[0] = std::byte(i);
+        }
+      }
+    });
+  }
+  threads.clear();
+  auto stats = pool->stats();
+  EXPECT_EQ(stats.mInUse, 0);
+  EXPECT_EQ(stats.mLeases + stats.mExhausted, 40000);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "coco/net.hpp"
+#include "coco/runtime.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr std::size_t kTotal = 1 << 20;
+
+auto writeAll(int fd) -> void
+{
+  auto chunk = std::vector<std::uint8_t>(4096);
+  for (std::size_t sent = 0; sent < kTotal;) {
+    for (std::size_t i = 0; i < chunk.size(); i++) {
+      chunk[i] = std::uint8_t((sent + i) % 251);
+    }
+    auto n = ::write(fd, chunk.data(), std::min(chunk.size(), kTotal - sent));
+    ASSERT_GT(n, 0);
+    sent += n;
+  }
+  ::shutdown(fd, SHUT_WR);
+}
+} // namespace
+
+TEST(BufferRing, LeaseWhileNotRegistered)
+{
+  auto ring = std::make_shared<coco::BufferRing>(3, 1000);
+  ASSERT_EQ(ring->stats().mCapacity, 4);
+  ASSERT_FALSE(ring->registered());
+  auto buffers = std::vector<coco::ProvidedBuffer>();
+  for (int i = 0; i < 4; i++) {
+    auto buf = ring->lease();
+    ASSERT_TRUE(buf);
+    ASSERT_EQ(buf.size(), 0);
+    ring->fill(buf, 5000);
+    ASSERT_EQ(buf.size(), 1000);
+    buffers.push_back(std::move(buf));
+  }
+  ASSERT_FALSE(ring->lease());
+  ASSERT_FALSE(ring->take(0, 10)); // a cqe which selected no buffer
+  EXPECT_EQ(ring->stats().mInUse, 4);
+
+  buffers.clear();
+  auto stats = ring->stats();
+  EXPECT_EQ(stats.mInUse, 0);
+  EXPECT_EQ(stats.mHighWater, 4);
+  ASSERT_TRUE(ring->lease());
+}
+
+TEST(BufferRing, MultishotRecvDeliversEverything)
+{
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  auto writer = std::jthread(writeAll, fds[1]);
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto received = std::size_t(0);
+  auto corrupt = false;
+  rt.block([](int fd, std::size_t& received, bool& corrupt) -> coco::Task<> {
+    auto stream = coco::sys::TcpStream::from(coco::sys::Socket(fd));
+    auto buffers = stream.recvMultishot(4);
+    while (true) {
+      auto [buf, errc] = co_await buffers.next();
+      if (errc == std::errc::no_buffer_space) {
+        continue;
+      }
+      if (errc != std::errc(0) || !buf) {
+        break;
+      }
+      for (auto b : buf.span()) {
+        corrupt |= std::uint8_t(b) != std::uint8_t(received % 251);
+        received++;
+      }
+    }
+  }(fds[0], received, corrupt));
+  writer.join();
+  ::close(fds[1]);
+  EXPECT_EQ(received, kTotal);
+  EXPECT_FALSE(corrupt);
+}
+
+TEST(BufferRing, RecvSelectsBufferOnArrival)
+{
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto size = std::size_t(0);
+  auto eof = false;
+  rt.block([](int fd, int peer, std::size_t& size, bool& eof) -> coco::Task<> {
+    auto stream = coco::sys::TcpStream::from(coco::sys::Socket(fd));
+    auto sender = std::jthread([peer] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      EXPECT_EQ(::write(peer, "hello", 5), 5);
+      ::shutdown(peer, SHUT_WR);
+    });
+    auto [buf, errc] = co_await stream.recv();
+    size = errc == std::errc(0) ? buf.size() : 0;
+    buf.release();
+    auto [last, errc2] = co_await stream.recv();
+    eof = errc2 == std::errc(0) && !last;
+  }(fds[0], fds[1], size, eof));
+  ::close(fds[1]);
+  EXPECT_EQ(size, 5);
+  EXPECT_TRUE(eof);
+}
\ No newline at end of file
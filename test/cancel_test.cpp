@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include "coco/cancel.hpp"
+#include "coco/runtime.hpp"
+
+#include <vector>
+
+using namespace std::chrono_literals;
+
+struct CountingNode : coco::detail::StopNode {
+  CountingNode() noexcept { mCancel = &cancel; }
+  static auto cancel(coco::detail::StopNode* node) noexcept -> void { static_cast<CountingNode*>(node)->mCount++; }
+  int mCount = 0;
+};
+
+TEST(Cancel, StopCancelsExactlyTheAttachedNodes)
+{
+  auto source = coco::StopSource();
+  auto token = source.token();
+  auto nodes = std::vector<CountingNode>(8);
+  for (auto& node : nodes) {
+    ASSERT_TRUE(token.attach(&node));
+  }
+  // completed operations leave before the stop
+  ASSERT_FALSE(token.detach(&nodes[0]));
+  ASSERT_FALSE(token.detach(&nodes[4]));
+  ASSERT_FALSE(token.detach(&nodes[7]));
+
+  ASSERT_TRUE(source.requestStop());
+  ASSERT_FALSE(source.requestStop());
+  ASSERT_TRUE(token.stopRequested());
+  for (std::size_t i = 0; i < nodes.size(); i++) {
+    auto const attached = i != 0 && i != 4 && i != 7;
+    EXPECT_EQ(nodes[i].mCount, attached ? 1 : 0);
+    if (attached) {
+      EXPECT_TRUE(token.detach(&nodes[i]));
+    }
+  }
+  auto late = CountingNode();
+  ASSERT_FALSE(token.attach(&late));
+  EXPECT_EQ(late.mCount, 0);
+}
+
+TEST(Cancel, DefaultTokenNeverStops)
+{
+  auto token = coco::CancellationToken();
+  auto node = CountingNode();
+  ASSERT_FALSE(token.stopPossible());
+  ASSERT_TRUE(token.attach(&node));
+  ASSERT_FALSE(token.detach(&node));
+  ASSERT_FALSE(token.stopRequested());
+}
+
+TEST(Cancel, StoppedTokenDoesNotSubmit)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto source = coco::StopSource();
+  source.requestStop();
+  auto errc = std::errc(0);
+  rt.block([](coco::Runtime& rt, coco::CancellationToken token, std::errc& errc) -> coco::Task<> {
+    errc = co_await rt.sleepFor(10s, token);
+  }(rt, source.token(), errc));
+  ASSERT_EQ(errc, std::errc::operation_canceled);
+}
+
+TEST(Cancel, StopCancelsSleepInFlight)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto source = coco::StopSource();
+  auto start = std::chrono::steady_clock::now();
+  auto errc = std::errc(0);
+  rt.block([](coco::Runtime& rt, coco::StopSource& source, std::errc& errc) -> coco::Task<> {
+    auto sleeper = rt.spawn(rt.sleepFor(10s, source.token()));
+    co_await rt.sleepFor(20ms);
+    source.requestStop();
+    co_await sleeper.join();
+    errc = sleeper.result();
+  }(rt, source, errc));
+  ASSERT_EQ(errc, std::errc::operation_canceled);
+  ASSERT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+TEST(Cancel, GroupStopCancelsChildren)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  auto started = std::atomic_int(0);
+  auto canceled = std::atomic_int(0);
+  rt.block([](coco::Runtime& rt, std::atomic_int& started, std::atomic_int& canceled) -> coco::Task<> {
+    auto group = coco::TaskGroup();
+    for (int i = 0; i < 64; i++) {
+      group.spawn([](coco::Runtime& rt, coco::CancellationToken token, std::atomic_int& started,
+                     std::atomic_int& canceled) -> coco::Task<> {
+        started.fetch_add(1);
+        if (co_await rt.sleepFor(10s, token) == std::errc::operation_canceled) {
+          canceled.fetch_add(1);
+        }
+      }(rt, group.token(), started, canceled));
+    }
+    co_await rt.sleepFor(20ms);
+    group.requestStop();
+    co_await group.join();
+  }(rt, started, canceled));
+  // children which didn't start before the stop are dropped, the others are cancelled
+  ASSERT_EQ(canceled.load(), started.load());
+}
\ No newline at end of file
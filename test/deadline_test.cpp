@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+
+#include <algorithm>
+#include <system_error>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Handles = std::vector<coco::Runtime::JoinHandle<coco::Task<>>>;
+
+auto record(int id, std::vector<int>& order) -> coco::Task<>
+{
+  order.push_back(id);
+  co_return;
+}
+
+auto joinAll(Handles& handles) -> coco::Task<>
+{
+  for (auto& handle : handles) {
+    co_await handle.join();
+  }
+}
+
+// one worker, so the spawned tasks queue up behind the spawning one and run in the order the worker picks them
+TEST(Deadline, EarliestDeadlineFirst)
+{
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto order = std::vector<int>();
+  rt.block([](coco::Runtime& rt, std::vector<int>& order) -> coco::Task<> {
+    auto const base = std::chrono::steady_clock::now() + 10s;
+    auto handles = Handles();
+    for (int id : {3, 0, 4, 1, 2}) {
+      handles.push_back(rt.spawn(record(id, order), {base + id * 1ms}));
+    }
+    co_await joinAll(handles);
+  }(rt, order));
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST(Deadline, WakeupsKeepTheDeadlineOrder)
+{
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto order = std::vector<int>();
+  rt.block([](std::vector<int>& order) -> coco::Task<> {
+    auto const base = std::chrono::steady_clock::now() + 10s;
+    auto tasks = std::vector<coco::Task<>>();
+    for (int id : {0, 1, 2, 3}) {
+      tasks.push_back(record(id, order).withDeadline({base + id * 1ms}));
+    }
+    // queued like wakeups, the last one would take the lifo slot and run first
+    for (auto& task : tasks) {
+      task.promise().setNextJob(&coco::detail::kEmptyJob);
+      coco::Proactor::get().execute(task.promise().getThisJob(), coco::ExeOpt::prefInOne());
+    }
+    for (auto& task : tasks) {
+      co_await coco::Runtime::JoinAwaiter(&task.promise().getNextJob());
+    }
+  }(order));
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(Deadline, ShedsWhatMissedItsDeadline)
+{
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto order = std::vector<int>();
+  auto shed = std::vector<int>();
+  rt.block([](coco::Runtime& rt, std::vector<int>& order, std::vector<int>& shed) -> coco::Task<> {
+    auto const now = std::chrono::steady_clock::now();
+    auto handles = Handles();
+    handles.push_back(rt.spawn(record(0, order), {now + 1ms, true}));
+    handles.push_back(rt.spawn(record(1, order), {now + 10s, true}));
+    handles.push_back(rt.spawn(record(2, order), {now + 1ms, false}));
+    // keep the only worker busy until the short deadlines passed
+    while (std::chrono::steady_clock::now() < now + 20ms) {
+    }
+    co_await coco::Yield();
+    for (int id = 0; id < int(handles.size()); id++) {
+      co_await handles[id].join();
+      try {
+        handles[id].result();
+      } catch (std::system_error const& e) {
+        EXPECT_EQ(e.code(), std::errc::timed_out);
+        shed.push_back(id);
+      }
+    }
+  }(rt, order, shed));
+  // a late task without shedding still runs, ahead of the one with time left
+  EXPECT_EQ(order, (std::vector<int>{2, 1}));
+  EXPECT_EQ(shed, (std::vector<int>{0}));
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include "coco/net.hpp"
+#include "coco/runtime.hpp"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr std::uint16_t kPort = 23473;
+
+// echoes one int on a worker which may not own the descriptor
+auto echo(coco::sys::DirectStream stream) -> coco::Task<>
+{
+  auto value = 0;
+  auto [len, errc] = co_await stream.recv(std::as_writable_bytes(std::span(&value, 1)));
+  if (errc != std::errc(0) || len != sizeof(value)) {
+    co_return;
+  }
+  auto [sent, sendErrc] = co_await stream.send(std::as_bytes(std::span(&value, 1)));
+  EXPECT_EQ(sendErrc, std::errc(0));
+  EXPECT_EQ(sent, sizeof(value));
+  EXPECT_EQ(co_await stream.close(), std::errc(0));
+}
+} // namespace
+
+TEST(DirectFd, FileRoundTrip)
+{
+  auto path = std::string("/tmp/coco_direct_XXXXXX");
+  auto tmp = ::mkstemp(path.data());
+  ASSERT_GE(tmp, 0);
+  ::close(tmp);
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto read = std::string();
+  rt.block([](std::string const& path, std::string& read) -> coco::Task<> {
+    using coco::sys::DirectFile;
+    auto [file, errc] = co_await DirectFile::open(path.c_str(), O_RDWR | O_TRUNC);
+    if (errc != std::errc(0)) {
+      co_return;
+    }
+    auto text = std::string_view("direct descriptors");
+    auto [written, errc2] = co_await file.write(std::as_bytes(std::span(text)), 0);
+    if (errc2 != std::errc(0)) {
+      co_return;
+    }
+    read.resize(written);
+    auto [len, errc3] = co_await file.read(std::as_writable_bytes(std::span(read)), 0);
+    read.resize(errc3 == std::errc(0) ? len : 0);
+    EXPECT_EQ(co_await file.close(), std::errc(0));
+  }(path, read));
+  ::unlink(path.c_str());
+  EXPECT_EQ(read, "direct descriptors");
+}
+
+TEST(DirectFd, ServedFromEveryWorker)
+{
+  using namespace coco::sys;
+  auto [listener, errc] = TcpListener::bind(SocketAddr(SocketAddrV4::loopback(kPort)));
+  ASSERT_EQ(errc, std::errc(0));
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto echoed = std::vector<int>(4, -1);
+  auto clients = std::jthread([&echoed] {
+    auto addr = ::sockaddr_in{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < int(echoed.size()); i++) {
+      auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+      ASSERT_GE(fd, 0);
+      ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+      ASSERT_EQ(::write(fd, &i, sizeof(i)), ssize_t(sizeof(i)));
+      auto value = -1;
+      if (::read(fd, &value, sizeof(value)) == sizeof(value)) {
+        echoed[i] = value;
+      }
+      ::close(fd);
+    }
+  });
+  rt.block([](coco::Runtime& rt, TcpListener& listener, std::size_t count) -> coco::Task<> {
+    for (std::size_t i = 0; i < count; i++) {
+      auto [stream, errc] = co_await listener.acceptDirect();
+      if (errc != std::errc(0)) {
+        co_return;
+      }
+      // every other connection is served by a worker which doesn't own its descriptor
+      auto handle = rt.spawnOn(std::uint32_t(i % 2), echo(std::move(stream)));
+      co_await handle.join();
+    }
+  }(rt, listener, echoed.size()));
+  clients.join();
+  for (int i = 0; i < int(echoed.size()); i++) {
+    EXPECT_EQ(echoed[i], i);
+  }
+}
+
+TEST(DirectFd, AcceptDirectStream)
+{
+  using namespace coco::sys;
+  auto [listener, errc] = TcpListener::bind(SocketAddr(SocketAddrV4::loopback(kPort + 1)));
+  ASSERT_EQ(errc, std::errc(0));
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto echoed = std::vector<int>(8, -1);
+  auto clients = std::jthread([&echoed] {
+    auto addr = ::sockaddr_in{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(kPort + 1);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < int(echoed.size()); i++) {
+      auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+      ASSERT_GE(fd, 0);
+      ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+      ASSERT_EQ(::write(fd, &i, sizeof(i)), ssize_t(sizeof(i)));
+      auto value = -1;
+      if (::read(fd, &value, sizeof(value)) == sizeof(value)) {
+        echoed[i] = value;
+      }
+      ::close(fd);
+    }
+  });
+  rt.block([](coco::Runtime& rt, TcpListener& listener, std::size_t count) -> coco::Task<> {
+    auto connections = listener.acceptDirectStream();
+    for (std::size_t i = 0; i < count; i++) {
+      auto [stream, errc] = co_await connections.next();
+      if (errc != std::errc(0)) {
+        co_return;
+      }
+      auto handle = rt.spawnOn(std::uint32_t(i % 2), echo(std::move(stream)));
+      co_await handle.join();
+    }
+  }(rt, listener, echoed.size()));
+  clients.join();
+  for (int i = 0; i < int(echoed.size()); i++) {
+    EXPECT_EQ(echoed[i], i);
+  }
+}
+
+TEST(DirectFd, PlainSocketCloseResumes)
+{
+  // a close goes through the pending set like every other op, otherwise the awaiting task hangs here
+  using namespace coco::sys;
+  auto [listener, errc] = TcpListener::bind(SocketAddr(SocketAddrV4::loopback(kPort + 2)));
+  ASSERT_EQ(errc, std::errc(0));
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto closed = std::vector<std::errc>();
+  rt.block([](TcpListener& listener, std::vector<std::errc>& closed) -> coco::Task<> {
+    auto [client, connectErrc] = co_await TcpStream::connect(SocketAddr(SocketAddrV4::loopback(kPort + 2)));
+    EXPECT_EQ(connectErrc, std::errc(0));
+    auto [server, acceptErrc] = co_await listener.accept();
+    EXPECT_EQ(acceptErrc, std::errc(0));
+    closed.push_back(co_await client.close());
+    closed.push_back(co_await server.close());
+    closed.push_back(co_await listener.close());
+  }(listener, closed));
+  EXPECT_EQ(closed, std::vector<std::errc>(3, std::errc(0)));
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+
+#include <vector>
+
+TEST(Elastic, CountIsClamped)
+{
+  auto rt = coco::Runtime(coco::MT, 2, {.mMaxThreads = 6, .mMinThreads = 2});
+  ASSERT_EQ(rt.workerCount(), 2);
+  ASSERT_EQ(rt.setWorkerCount(6), 6);
+  ASSERT_EQ(rt.setWorkerCount(100), 6);
+  ASSERT_EQ(rt.setWorkerCount(0), 2);
+  ASSERT_EQ(rt.workerCount(), 2);
+}
+
+TEST(Elastic, FixedWithoutMaxThreads)
+{
+  auto rt = coco::Runtime(coco::MT, 3);
+  ASSERT_EQ(rt.setWorkerCount(8), 3);
+  ASSERT_EQ(rt.setWorkerCount(1), 1);
+  ASSERT_EQ(rt.setWorkerCount(3), 3);
+}
+
+auto napAndCount(coco::Runtime& rt, std::atomic_int& done) -> coco::Task<>
+{
+  co_await rt.sleepFor(std::chrono::milliseconds(20));
+  co_await coco::Yield();
+  done.fetch_add(1);
+}
+
+TEST(Elastic, SleepersSurviveResizing)
+{
+  auto rt = coco::Runtime(coco::MT, 4, {.mMaxThreads = 4});
+  auto done = std::atomic_int(0);
+  rt.block([](coco::Runtime& rt, std::atomic_int& done) -> coco::Task<> {
+    for (int round = 0; round < 3; round++) {
+      auto handles = std::vector<coco::Runtime::JoinHandle<coco::Task<>>>();
+      for (int i = 0; i < 200; i++) {
+        handles.push_back(rt.spawn(napAndCount(rt, done)));
+      }
+      // the timers of the retired workers move to the remaining one, then come back when they are reactivated
+      rt.setWorkerCount(1);
+      co_await rt.sleepFor(std::chrono::milliseconds(5));
+      rt.setWorkerCount(4);
+      for (auto& handle : handles) {
+        co_await handle.join();
+      }
+    }
+  }(rt, done));
+  ASSERT_EQ(done.load(), 600);
+}
+
+TEST(Elastic, ControllerShrinksWhenIdle)
+{
+  auto rt = coco::Runtime(coco::MT, 4, {.mMaxThreads = 4, .mScaleInterval = std::chrono::milliseconds(1)});
+  auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (rt.workerCount() > 1 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(rt.workerCount(), 1);
+  // the remaining worker still runs tasks
+  auto done = std::atomic_int(0);
+  rt.block(napAndCount(rt, done));
+  ASSERT_EQ(done.load(), 1);
+}
\ No newline at end of file
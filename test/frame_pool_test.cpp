@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include "coco/util/frame_pool.hpp"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using coco::util::FramePool;
+
+TEST(FramePool, ReuseLocal)
+{
+  auto before = FramePool::stats();
+  auto ptr = FramePool::allocate(100);
+  FramePool::deallocate(ptr, 100);
+  auto again = FramePool::allocate(90);
+  ASSERT_EQ(ptr, again);
+  FramePool::deallocate(again, 90);
+
+  auto after = FramePool::stats();
+  ASSERT_EQ(after.mAllocs - before.mAllocs, 2);
+  ASSERT_GE(after.mHits - before.mHits, 1);
+  ASSERT_GT(after.mRetainedBytes, 0);
+}
+
+TEST(FramePool, LargeFrame)
+{
+  auto ptr = FramePool::allocate(64 * 1024);
+  std::memset(ptr, 0, 64 * 1024);
+  FramePool::deallocate(ptr, 64 * 1024);
+}
+
+TEST(FramePool, RemoteFree)
+{
+  constexpr int kCount = 1000;
+  auto frames = std::vector<void*>();
+  for (int i = 0; i < kCount; i++) {
+    frames.push_back(FramePool::allocate(200));
+  }
+  auto th = std::thread([&] {
+    for (auto frame : frames) {
+      FramePool::deallocate(frame, 200);
+    }
+  });
+  th.join();
+
+  // frames freed by the exited thread come back to this one
+  auto before = FramePool::stats();
+  for (int i = 0; i < kCount; i++) {
+    frames[i] = FramePool::allocate(200);
+  }
+  auto after = FramePool::stats();
+  ASSERT_GT(after.mHits - before.mHits, 0);
+  for (auto frame : frames) {
+    FramePool::deallocate(frame, 200);
+  }
+}
\ No newline at end of file
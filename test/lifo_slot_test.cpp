@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+#include "coco/sync/channel.hpp"
+
+#include <atomic>
+
+namespace {
+constexpr int kStartRound = 10;
+constexpr int kMaxRounds = 100'000;
+
+// every channel hand-over wakes the other side with `ExeOpt::PreferInOne`, so the pair keeps swapping through the
+// lifo slot of the worker
+auto pingLoop(coco::Runtime& rt, coco::sync::Channel<int, 1>& ping, coco::sync::Channel<int, 1>& pong,
+              std::atomic_int& rounds, std::atomic_int& seen) -> coco::Task<>
+{
+  for (int i = 0; seen.load() < 0 && i < kMaxRounds; i++) {
+    if (i == kStartRound) {
+      rt.spawnDetach([](std::atomic_int& rounds, std::atomic_int& seen) -> coco::Task<> {
+        seen.store(rounds.load());
+        co_return;
+      }(rounds, seen));
+    }
+    co_await ping.write(i);
+    co_await pong.read();
+    rounds.store(i + 1);
+  }
+  ping.close();
+}
+
+auto pongLoop(coco::sync::Channel<int, 1>& ping, coco::sync::Channel<int, 1>& pong) -> coco::Task<>
+{
+  while (auto value = co_await ping.read()) {
+    co_await pong.write(*value);
+  }
+}
+} // namespace
+
+TEST(LifoSlot, PingPongDoesntStarveTheQueue)
+{
+  // one worker, so the queued job only runs once the pair leaves the lifo slot
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto rounds = std::atomic_int(0);
+  auto seen = std::atomic_int(-1);
+  rt.block([](coco::Runtime& rt, std::atomic_int& rounds, std::atomic_int& seen) -> coco::Task<> {
+    auto ping = coco::sync::Channel<int, 1>();
+    auto pong = coco::sync::Channel<int, 1>();
+    auto ponger = rt.spawn(pongLoop(ping, pong));
+    auto pinger = rt.spawn(pingLoop(rt, ping, pong, rounds, seen));
+    co_await pinger.join();
+    co_await ponger.join();
+  }(rt, rounds, seen));
+  ASSERT_GE(seen.load(), kStartRound);
+  // the cap lets the pair go on for a couple of rounds, without it the job would wait for all of them
+  EXPECT_LE(seen.load() - kStartRound, 8);
+}
\ No newline at end of file
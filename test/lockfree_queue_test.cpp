@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include "coco/util/lockfree_queue.hpp"
+
+#include <thread>
+#include <vector>
+
+struct Node {
+  int i;
+  Node* next = nullptr;
+};
+
+TEST(MpscQueue, Fifo)
+{
+  auto queue = coco::util::MpscQueue<&Node::next>();
+  auto nodes = std::vector<Node>(6);
+  for (int i = 0; i < 3; i++) {
+    nodes[i].i = i;
+    queue.push(&nodes[i]);
+  }
+  auto batch = coco::util::Queue<&Node::next>();
+  for (int i = 3; i < 6; i++) {
+    nodes[i].i = i;
+    batch.pushBack(&nodes[i]);
+  }
+  queue.push(std::move(batch));
+
+  auto out = queue.popAll();
+  ASSERT_TRUE(queue.empty());
+  for (int i = 0; i < 6; i++) {
+    ASSERT_EQ(out.popFront()->i, i);
+  }
+  ASSERT_TRUE(out.empty());
+  ASSERT_TRUE(queue.popAll().empty());
+}
+
+TEST(MpscQueue, Concurrent)
+{
+  constexpr int kProducers = 4;
+  constexpr int kCount = 100'000;
+  auto queue = coco::util::MpscQueue<&Node::next>();
+  auto nodes = std::vector<Node>(kProducers * kCount);
+  auto threads = std::vector<std::thread>();
+  for (int t = 0; t < kProducers; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kCount; i++) {
+        auto& node = nodes[t * kCount + i];
+        node.i = i;
+        queue.push(&node);
+      }
+    });
+  }
+  auto last = std::vector<int>(kProducers, -1);
+  auto received = 0;
+  auto ordered = true;
+  // drain everything even after a mismatch, the producers must be joined before the test may fail
+  while (received < kProducers * kCount) {
+    auto out = queue.popAll();
+    while (auto node = out.popFront()) {
+      auto producer = (node - nodes.data()) / kCount;
+      ordered = ordered && node->i == last[producer] + 1; // per producer order is kept
+      last[producer] = node->i;
+      received += 1;
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(ordered);
+}
\ No newline at end of file
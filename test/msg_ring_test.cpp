@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+
+#include <atomic>
+#include <system_error>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr int kRounds = 200;
+constexpr int kFanOut = 8;
+
+auto count(std::vector<std::atomic_int>& counts, int i) -> coco::Task<>
+{
+  counts[i].fetch_add(1);
+  co_return;
+}
+
+// spawns from a worker while the others are parked, which is when jobs are handed over in the wakeup cqe
+auto fanOuts(coco::Runtime& rt, std::vector<std::atomic_int>& counts) -> coco::Task<>
+{
+  for (int round = 0; round < kRounds; round++) {
+    co_await rt.sleepFor(1ms);
+    auto handles = std::vector<coco::Runtime::JoinHandle<coco::Task<>>>();
+    for (int i = 0; i < kFanOut; i++) {
+      handles.push_back(rt.spawn(count(counts, round * kFanOut + i)));
+    }
+    for (auto& handle : handles) {
+      co_await handle.join();
+    }
+  }
+}
+} // namespace
+
+TEST(MsgRing, HandedOverJobsRunOnce)
+{
+  // with `mMsgRing` off, or on kernels without IORING_OP_MSG_RING, the same jobs take the inbox and the eventfd
+  for (auto msgRing : {true, false}) {
+    auto rt = coco::Runtime(coco::MT, 4, {.mMsgRing = msgRing});
+    auto counts = std::vector<std::atomic_int>(kRounds * kFanOut);
+    rt.block(fanOuts(rt, counts));
+    for (auto& c : counts) {
+      ASSERT_EQ(c.load(), 1);
+    }
+    auto stats = rt.stats();
+    if (!stats.mEnabled) {
+      continue;
+    }
+    auto total = stats.total();
+    ASSERT_LE(total.mHandOvers, total.mUnparks);
+    if (!msgRing) {
+      ASSERT_EQ(total.mHandOvers, 0);
+    }
+  }
+}
+
+TEST(MsgRing, DetachedJobsRunOnce)
+{
+  for (auto msgRing : {true, false}) {
+    auto rt = coco::Runtime(coco::MT, 4, {.mMsgRing = msgRing});
+    auto done = std::atomic_int(0);
+    rt.block([](coco::Runtime& rt, std::atomic_int& done) -> coco::Task<> {
+      for (int round = 0; round < kRounds; round++) {
+        co_await rt.sleepFor(1ms);
+        for (int i = 0; i < kFanOut; i++) {
+          rt.spawnDetach([](std::atomic_int& done) -> coco::Task<> {
+            done.fetch_add(1);
+            co_return;
+          }(done));
+        }
+      }
+      while (done.load() != kRounds * kFanOut) {
+        co_await rt.sleepFor(1ms);
+      }
+    }(rt, done));
+    ASSERT_EQ(done.load(), kRounds * kFanOut);
+  }
+}
+
+TEST(MsgRing, HandedOverJobsAreShedLikeQueuedOnes)
+{
+  // a handed-over job is queued on the receiver like any other, so it keeps its deadline and is shed once it passed
+  auto rt = coco::Runtime(coco::MT, 4, {.mMsgRing = true});
+  auto ran = std::atomic_int(0);
+  rt.block([](coco::Runtime& rt, std::atomic_int& ran) -> coco::Task<> {
+    for (int round = 0; round < kRounds; round++) {
+      co_await rt.sleepFor(1ms);
+      auto const missed = coco::Deadline{std::chrono::steady_clock::now() - 1s, true};
+      auto handles = std::vector<coco::Runtime::JoinHandle<coco::Task<>>>();
+      for (int i = 0; i < kFanOut; i++) {
+        handles.push_back(rt.spawn(
+            [](std::atomic_int& ran) -> coco::Task<> {
+              ran.fetch_add(1);
+              co_return;
+            }(ran),
+            missed));
+      }
+      for (auto& handle : handles) {
+        co_await handle.join();
+        EXPECT_THROW(handle.result(), std::system_error);
+      }
+    }
+  }(rt, ran));
+  EXPECT_EQ(ran.load(), 0);
+}
\ No newline at end of file
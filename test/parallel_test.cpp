@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+TEST(Parallel, ForVisitsEveryElementOnce)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  auto counts = std::vector<std::atomic_int>(10'007);
+  rt.block([](coco::Runtime& rt, std::vector<std::atomic_int>& counts) -> coco::Task<> {
+    co_await rt.parallelFor(counts, 64, [](std::atomic_int& count) { count.fetch_add(1); });
+  }(rt, counts));
+  for (auto& count : counts) {
+    ASSERT_EQ(count.load(), 1);
+  }
+}
+
+TEST(Parallel, ForSmallRanges)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  auto sum = std::atomic_int(0);
+  rt.block([](coco::Runtime& rt, std::atomic_int& sum) -> coco::Task<> {
+    co_await rt.parallelFor(std::views::iota(0, 0), 16, [&](int i) { sum += i; });
+    co_await rt.parallelFor(std::views::iota(0, 1), 16, [&](int) { sum += 1; });
+    co_await rt.parallelFor(std::views::iota(0, 5), 0, [&](int) { sum += 1; });
+  }(rt, sum));
+  ASSERT_EQ(sum.load(), 6);
+}
+
+TEST(Parallel, TinyChunksRepeated)
+{
+  // the caller's chunk often finishes last, right as the frame holding the fork-join state is freed and reused by the
+  // next round, so a late write by the finishing worker shows up here, or under ASan
+  auto rt = coco::Runtime(coco::MT, 4);
+  auto sum = std::atomic_int(0);
+  rt.block([](coco::Runtime& rt, std::atomic_int& sum) -> coco::Task<> {
+    for (int round = 0; round < 5000; round++) {
+      co_await rt.parallelFor(std::views::iota(0, 8 + round % 32), 1, [&](int) { sum.fetch_add(1); });
+    }
+  }(rt, sum));
+  auto expected = 0;
+  for (int round = 0; round < 5000; round++) {
+    expected += 8 + round % 32;
+  }
+  ASSERT_EQ(sum.load(), expected);
+}
+
+TEST(Parallel, ReduceKeepsOrder)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  auto words = std::vector<std::string>();
+  for (int i = 0; i < 1000; i++) {
+    words.push_back(std::to_string(i % 10));
+  }
+  auto expected = std::accumulate(words.begin(), words.end(), std::string());
+  auto result = std::string();
+  rt.block([](coco::Runtime& rt, std::vector<std::string>& words, std::string& result) -> coco::Task<> {
+    result = co_await rt.parallelReduce(words, 7, std::string(), std::plus<>());
+  }(rt, words, result));
+  ASSERT_EQ(result, expected);
+}
+
+TEST(Parallel, Sort)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  auto values = std::vector<int>(100'003);
+  auto rng = std::mt19937(7);
+  std::generate(values.begin(), values.end(), [&] { return int(rng() % 1000); });
+  auto expected = values;
+  std::sort(expected.begin(), expected.end(), std::greater<>());
+  rt.block([](coco::Runtime& rt, std::vector<int>& values) -> coco::Task<> {
+    co_await rt.parallelSort(values, 1000, std::greater<>());
+  }(rt, values));
+  ASSERT_EQ(values, expected);
+}
+
+TEST(Parallel, Exception)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  auto caught = false;
+  rt.block([](coco::Runtime& rt, bool& caught) -> coco::Task<> {
+    try {
+      co_await rt.parallelFor(std::views::iota(0, 1000), 10, [](int i) {
+        if (i == 500) {
+          throw std::runtime_error("chunk failed");
+        }
+      });
+    } catch (std::runtime_error const&) {
+      caught = true;
+    }
+  }(rt, caught));
+  ASSERT_TRUE(caught);
+}
+
+TEST(Parallel, Inline)
+{
+  auto rt = coco::Runtime(coco::INL);
+  auto sum = 0L;
+  rt.block([](coco::Runtime& rt, long& sum) -> coco::Task<> {
+    sum = co_await rt.parallelReduce(std::views::iota(0L, 1000L), 10, 0L, std::plus<>());
+  }(rt, sum));
+  ASSERT_EQ(sum, 999L * 1000 / 2);
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using coco::Priority;
+using Handles = std::vector<coco::Runtime::JoinHandle<coco::Task<>>>;
+
+auto record(Priority prio, std::vector<Priority>& order) -> coco::Task<>
+{
+  order.push_back(prio);
+  co_return;
+}
+
+auto joinAll(Handles& handles) -> coco::Task<>
+{
+  for (auto& handle : handles) {
+    co_await handle.join();
+  }
+}
+
+// one worker, so the spawned tasks queue up behind the spawning one and run in the order the worker picks them
+TEST(Priority, HigherClassGoesFirst)
+{
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto order = std::vector<Priority>();
+  rt.block([](coco::Runtime& rt, std::vector<Priority>& order) -> coco::Task<> {
+    auto handles = Handles();
+    for (auto prio : {Priority::Background, Priority::Normal, Priority::Interactive, Priority::Critical}) {
+      handles.push_back(rt.spawn(record(prio, order).withPriority(prio)));
+    }
+    co_await joinAll(handles);
+  }(rt, order));
+  ASSERT_EQ(order.size(), 4);
+  EXPECT_EQ(order.front(), Priority::Critical);
+}
+
+TEST(Priority, ClassesShareByWeight)
+{
+  // the default weights give `Critical` 16 run slots for each one of `Background`
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto order = std::vector<Priority>();
+  rt.block([](coco::Runtime& rt, std::vector<Priority>& order) -> coco::Task<> {
+    auto handles = Handles();
+    for (int i = 0; i < 400; i++) {
+      handles.push_back(rt.spawn(record(Priority::Background, order).withPriority(Priority::Background)));
+      handles.push_back(rt.spawn(record(Priority::Critical, order).withPriority(Priority::Critical)));
+    }
+    co_await joinAll(handles);
+  }(rt, order));
+  ASSERT_EQ(order.size(), 800);
+  // while both classes have jobs queued
+  auto const background = std::count(order.begin(), order.begin() + 340, Priority::Background);
+  EXPECT_GE(background, 18);
+  EXPECT_LE(background, 22);
+  // and the low class isn't starved meanwhile
+  EXPECT_GT(std::count(order.begin(), order.begin() + 17, Priority::Background), 0);
+}
+
+TEST(Priority, ChildrenInheritTheClass)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  rt.block([](coco::Runtime& rt) -> coco::Task<> {
+    auto parent = [](coco::Runtime& rt) -> coco::Task<> {
+      // created while the parent runs, so it starts in the parent's class
+      auto child = []() -> coco::Task<> { co_return; }();
+      EXPECT_EQ(child.promise().priority(), Priority::Interactive);
+      auto spawned = rt.spawn(std::move(child));
+      co_await spawned.join();
+      // unless it is given one
+      auto other = []() -> coco::Task<> { co_return; }().withPriority(Priority::Background);
+      EXPECT_EQ(other.promise().priority(), Priority::Background);
+      co_await std::move(other);
+    };
+    co_await rt.spawn(parent(rt).withPriority(Priority::Interactive)).join();
+  }(rt));
+}
+
+TEST(Priority, ClassDoesNotStickToTheThread)
+{
+  // the inline runtime runs everything on this thread
+  auto rt = coco::Runtime(coco::INL);
+  rt.block([](coco::Runtime& rt) -> coco::Task<> {
+    auto parent = [](coco::Runtime& rt) -> coco::Task<> {
+      auto child = []() -> coco::Task<> { co_return; }().withPriority(Priority::Background);
+      co_await rt.spawn(std::move(child)).join();
+      // after awaiting a lower class child, new tasks still start in the parent's class
+      auto next = []() -> coco::Task<> { co_return; }();
+      EXPECT_EQ(next.promise().priority(), Priority::Critical);
+      co_await std::move(next);
+    };
+    co_await rt.spawn(parent(rt).withPriority(Priority::Critical)).join();
+  }(rt).withPriority(Priority::Background));
+  // and a task created outside of any task starts in `Normal`, whatever ran here last
+  auto outside = []() -> coco::Task<> { co_return; }();
+  EXPECT_EQ(outside.promise().priority(), Priority::Normal);
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <ranges>
+#include <vector>
+
+namespace {
+auto count(std::vector<std::atomic_int>& counts, int i) -> coco::Task<int>
+{
+  counts[i].fetch_add(1);
+  if (i % 3 == 0) {
+    co_await coco::Yield();
+  }
+  co_return i;
+}
+
+auto countDetached(std::vector<std::atomic_int>& counts, int i, std::atomic_int& done) -> coco::Task<>
+{
+  counts[i].fetch_add(1);
+  if (i % 3 == 0) {
+    co_await coco::Yield();
+  }
+  done.fetch_add(1);
+}
+} // namespace
+
+TEST(SpawnBatch, RunsEveryTaskOnceAndJoins)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  // below the worker count, within the growing batches and past the largest one
+  for (int n : {0, 1, 3, 1000, 100'003}) {
+    auto counts = std::vector<std::atomic_int>(n);
+    rt.block([](coco::Runtime& rt, std::vector<std::atomic_int>& counts, int n) -> coco::Task<> {
+      auto handles = rt.spawnBatch(std::views::iota(0, n) | std::views::transform([&](int i) {
+                                     return count(counts, i);
+                                   }));
+      EXPECT_EQ(handles.size(), std::size_t(n));
+      auto sum = std::int64_t(0);
+      for (auto& handle : handles) {
+        co_await handle.join();
+        sum += handle.result();
+      }
+      EXPECT_EQ(sum, std::int64_t(n) * (n - 1) / 2);
+    }(rt, counts, n));
+    for (auto& c : counts) {
+      ASSERT_EQ(c.load(), 1);
+    }
+  }
+}
+
+TEST(SpawnBatch, ManyRunsEveryTaskOnce)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  for (int n : {0, 1, 3, 1000, 100'003}) {
+    auto counts = std::vector<std::atomic_int>(n);
+    auto done = std::atomic_int(0);
+    rt.block([](coco::Runtime& rt, std::vector<std::atomic_int>& counts, int n, std::atomic_int& done) -> coco::Task<> {
+      rt.spawnMany(std::views::iota(0, n) | std::views::transform([&](int i) {
+                     return countDetached(counts, i, done);
+                   }));
+      while (done.load() != n) {
+        co_await coco::Yield();
+      }
+    }(rt, counts, n, done));
+    for (auto& c : counts) {
+      ASSERT_EQ(c.load(), 1);
+    }
+  }
+}
\ No newline at end of file
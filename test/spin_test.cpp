@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+auto tiny() -> coco::Task<> { co_return; }
+
+// joins one task after another with a busy pause in between, so the other workers go idle right before the next
+// task comes: short pauses end while they spin, long ones after they parked
+auto roundTrips(coco::Runtime& rt, int rounds, std::chrono::microseconds pause) -> coco::Task<>
+{
+  for (int i = 0; i < rounds; i++) {
+    co_await rt.spawn(tiny()).join();
+    auto const start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < pause) {
+    }
+  }
+}
+} // namespace
+
+TEST(Spin, NoLostWakeups)
+{
+  for (auto spinMax : {0u, 4096u}) {
+    auto rt = coco::Runtime(coco::MT, 4, {.mSpinMax = spinMax});
+    auto const start = std::chrono::steady_clock::now();
+    // pauses around the spin budget, where a worker gives up spinning as the task arrives
+    for (auto pause : {0us, 1us, 10us, 50us, 200us}) {
+      rt.block(roundTrips(rt, 2000, pause));
+    }
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 20s);
+  }
+}
+
+TEST(Spin, FindsBackToBackWork)
+{
+  if (std::thread::hardware_concurrency() < 2) {
+    GTEST_SKIP() << "workers only spin with another cpu to produce the work";
+  }
+  auto rt = coco::Runtime(coco::MT, 2);
+  rt.block(roundTrips(rt, 2000, 0us));
+  auto stats = rt.stats();
+  if (!stats.mEnabled) {
+    return;
+  }
+  ASSERT_GT(stats.total().mSpinHits, 0);
+}
+
+TEST(Spin, ParksWhenNothingComes)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  rt.block([](coco::Runtime& rt) -> coco::Task<> {
+    co_await rt.spawn(tiny()).join();
+    // far longer than any spin, both workers end up parked
+    co_await rt.sleepFor(20ms);
+    co_await rt.spawn(tiny()).join();
+  }(rt));
+  auto stats = rt.stats();
+  if (!stats.mEnabled) {
+    return;
+  }
+  auto total = stats.total();
+  ASSERT_GT(total.mParks, 0);
+  if (std::thread::hardware_concurrency() > 1) {
+    ASSERT_GT(total.mSpinMisses, 0);
+  }
+}
+
+TEST(Spin, DisabledNeverSpins)
+{
+  auto rt = coco::Runtime(coco::MT, 2, {.mSpinMax = 0});
+  rt.block(roundTrips(rt, 200, 0us));
+  auto total = rt.stats().total();
+  ASSERT_EQ(total.mSpinHits, 0);
+  ASSERT_EQ(total.mSpinMisses, 0);
+}
\ No newline at end of file
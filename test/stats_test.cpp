@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+
+#include <vector>
+
+auto bump(std::atomic_int& done) -> coco::Task<>
+{
+  co_await coco::Yield();
+  done.fetch_add(1);
+}
+
+auto spawnAndJoin(coco::Runtime& rt, std::atomic_int& done, int count) -> coco::Task<>
+{
+  auto handles = std::vector<coco::Runtime::JoinHandle<coco::Task<>>>();
+  for (int i = 0; i < count; i++) {
+    handles.push_back(rt.spawn(bump(done)));
+  }
+  for (auto& handle : handles) {
+    co_await handle.join();
+  }
+}
+
+TEST(Stats, HistogramPercentile)
+{
+  auto histogram = coco::Histogram{};
+  ASSERT_EQ(histogram.percentile(0.5), 0);
+  for (std::uint64_t value : {0, 1, 2, 3, 5, 9, 100}) {
+    histogram.mBuckets[coco::Histogram::bucketOf(value)]++;
+  }
+  ASSERT_EQ(histogram.count(), 7);
+  ASSERT_EQ(histogram.percentile(0.0), 0);
+  ASSERT_EQ(histogram.percentile(0.5), 3);
+  ASSERT_EQ(histogram.percentile(1.0), 127);
+  ASSERT_EQ(coco::Histogram::bucketOf(~std::uint64_t(0)), coco::Histogram::kBuckets - 1);
+}
+
+TEST(Stats, MultiThreadCounters)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  auto done = std::atomic_int(0);
+  rt.block(spawnAndJoin(rt, done, 1000));
+  ASSERT_EQ(done.load(), 1000);
+
+  auto stats = rt.stats();
+  ASSERT_EQ(stats.mWorkers.size(), 4);
+  auto total = stats.total();
+  if (!stats.mEnabled) {
+    ASSERT_EQ(total.mJobsRun, 0);
+    ASSERT_EQ(total.mBatchSizes.count(), 0);
+    return;
+  }
+  // every task runs at least twice around its yield, and the main task resumes once per join
+  ASSERT_GE(total.mJobsRun, 2000);
+  ASSERT_GE(total.mLocalEnqueues + total.mRemoteEnqueues, 1000);
+  ASSERT_GT(total.mBatchSizes.count(), 0);
+  ASSERT_GT(total.mQueueHighWater, 0);
+  // workers wait for the main task before it is spawned
+  ASSERT_GT(total.mParks, 0);
+}
+
+TEST(Stats, PerCoreCounters)
+{
+  auto rt = coco::Runtime(coco::TPC, 2);
+  auto done = std::atomic_int(0);
+  rt.block(spawnAndJoin(rt, done, 500));
+  ASSERT_EQ(done.load(), 500);
+
+  auto stats = rt.stats();
+  ASSERT_EQ(stats.mWorkers.size(), 2);
+  if (stats.mEnabled) {
+    // spawned from core 0 everything stays on it
+    ASSERT_GE(stats.mWorkers[0].mJobsRun, 1000);
+    ASSERT_GE(stats.mWorkers[0].mLocalEnqueues, 500);
+  }
+}
+
+TEST(Stats, InlineKeepsNone)
+{
+  auto rt = coco::Runtime(coco::INL);
+  ASSERT_TRUE(rt.stats().mWorkers.empty());
+}
\ No newline at end of file
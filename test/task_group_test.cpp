@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+#include "coco/task_group.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+// allocations made by the current thread, to check that spawning into a group only allocates frames
+static thread_local std::size_t tAllocations = 0;
+auto operator new(std::size_t size) -> void*
+{
+  tAllocations++;
+  if (auto ptr = std::malloc(size); ptr != nullptr) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+auto operator delete(void* ptr) noexcept -> void { std::free(ptr); }
+auto operator delete(void* ptr, std::size_t) noexcept -> void { std::free(ptr); }
+
+auto bump(std::atomic_int& done) -> coco::Task<>
+{
+  co_await coco::Yield();
+  done.fetch_add(1);
+}
+
+auto fail() -> coco::Task<>
+{
+  throw std::runtime_error("child failed");
+  co_return;
+}
+
+TEST(TaskGroup, JoinWaitsForAllChildren)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  auto done = std::atomic_int(0);
+  rt.block([](std::atomic_int& done) -> coco::Task<> {
+    auto group = coco::TaskGroup();
+    for (int i = 0; i < 1000; i++) {
+      group.spawn(bump(done));
+    }
+    co_await group.join();
+    EXPECT_EQ(done.load(), 1000);
+  }(done));
+  ASSERT_EQ(done.load(), 1000);
+}
+
+TEST(TaskGroup, EmptyAndFinishedGroups)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto done = std::atomic_int(0);
+  rt.block([](coco::Runtime& rt, std::atomic_int& done) -> coco::Task<> {
+    auto empty = coco::TaskGroup();
+    co_await empty.join();
+    // children done before the join don't make it suspend
+    auto group = coco::TaskGroup();
+    group.spawn(bump(done));
+    co_await rt.sleepFor(std::chrono::milliseconds(10));
+    co_await group.join();
+  }(rt, done));
+  ASSERT_EQ(done.load(), 1);
+}
+
+TEST(TaskGroup, FirstExceptionStopsTheGroup)
+{
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto done = std::atomic_int(0);
+  auto caught = false;
+  rt.block([](std::atomic_int& done, bool& caught) -> coco::Task<> {
+    auto group = coco::TaskGroup();
+    group.spawn(fail());
+    for (int i = 0; i < 1000; i++) {
+      group.spawn(bump(done));
+    }
+    try {
+      co_await group.join();
+    } catch (std::runtime_error const& e) {
+      caught = true;
+    }
+    EXPECT_TRUE(group.stopRequested());
+  }(done, caught));
+  ASSERT_TRUE(caught);
+  // the children queued behind the failing one are dropped
+  ASSERT_LT(done.load(), 1000);
+}
+
+TEST(TaskGroup, SpawnOnlyAllocatesFrames)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto done = std::atomic_int(0);
+  auto allocations = std::size_t(0);
+  rt.block([](std::atomic_int& done, std::size_t& allocations) -> coco::Task<> {
+    auto group = coco::TaskGroup();
+    auto const before = tAllocations;
+    for (int i = 0; i < 100; i++) {
+      group.spawn(bump(done));
+    }
+    allocations = tAllocations - before;
+    co_await group.join();
+  }(done, allocations));
+  ASSERT_EQ(done.load(), 100);
+  ASSERT_LE(allocations, 100);
+}
+
+TEST(TaskGroup, WaitAllTasks)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto done = std::atomic_int(0);
+  rt.block([](coco::Runtime& rt, std::atomic_int& done) -> coco::Task<> {
+    co_await rt.waitAll(bump(done), bump(done), bump(done));
+    EXPECT_EQ(done.load(), 3);
+    auto caught = false;
+    try {
+      co_await rt.waitAll(bump(done), fail());
+    } catch (std::runtime_error const& e) {
+      caught = true;
+    }
+    EXPECT_TRUE(caught);
+  }(rt, done));
+}
\ No newline at end of file
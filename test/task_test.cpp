@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+// the awaiter of a task, recording whether awaiting it suspended the parent
+template <typename Awaiter>
+struct Probe {
+  auto await_ready() noexcept -> bool { return mAwaiter.await_ready(); }
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> bool
+  {
+    mSuspended = mAwaiter.await_suspend(handle);
+    return mSuspended;
+  }
+  auto await_resume() -> decltype(auto) { return mAwaiter.await_resume(); }
+
+  Awaiter mAwaiter;
+  bool& mSuspended;
+};
+template <typename T>
+auto probe(coco::Task<T>&& task, bool& suspended)
+{
+  return Probe<decltype(std::move(task).operator co_await())>{std::move(task).operator co_await(), suspended};
+}
+
+[[gnu::noinline]] auto stackPosition() -> std::uintptr_t
+{
+  return reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0));
+}
+
+// suspends and queues the task again, so that it completes later and maybe on another worker
+struct Requeue {
+  auto await_ready() noexcept -> bool { return false; }
+  template <typename Promise>
+  auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> void
+  {
+    coco::Proactor::get().execute(handle.promise().getThisJob(), coco::ExeOpt::balance());
+  }
+  auto await_resume() noexcept -> void {}
+};
+
+auto ready(int v) -> coco::Task<int> { co_return v; }
+
+auto yielding(int v, std::thread::id& completedOn) -> coco::Task<int>
+{
+  co_await Requeue();
+  completedOn = std::this_thread::get_id();
+  co_return v;
+}
+
+// the extent of the stack used by the leaves, across all awaits
+struct StackRange {
+  auto record() noexcept -> void
+  {
+    auto const pos = stackPosition();
+    mLow = std::min(mLow, pos);
+    mHigh = std::max(mHigh, pos);
+  }
+  std::uintptr_t mLow = UINTPTR_MAX;
+  std::uintptr_t mHigh = 0;
+};
+
+auto leaf(int i, StackRange& range) -> coco::Task<int>
+{
+  if (i % 2 == 1) {
+    co_await Requeue();
+  }
+  range.record();
+  co_return i;
+}
+} // namespace
+
+TEST(Task, ReadyChildDoesntSuspendTheParent)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto suspended = true;
+  auto value = 0;
+  rt.block([](bool& suspended, int& value) -> coco::Task<> {
+    value = co_await probe(ready(7), suspended);
+  }(suspended, value));
+  EXPECT_FALSE(suspended);
+  EXPECT_EQ(value, 7);
+}
+
+TEST(Task, ParentResumesWhereTheChildCompletes)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  for (int i = 0; i < 100; i++) {
+    auto suspended = false;
+    auto completedOn = std::thread::id();
+    auto resumedOn = std::thread::id();
+    rt.block([](bool& suspended, std::thread::id& completedOn, std::thread::id& resumedOn) -> coco::Task<> {
+      auto value = co_await probe(yielding(3, completedOn), suspended);
+      resumedOn = std::this_thread::get_id();
+      EXPECT_EQ(value, 3);
+    }(suspended, completedOn, resumedOn));
+    EXPECT_TRUE(suspended);
+    EXPECT_EQ(resumedOn, completedOn);
+  }
+}
+
+TEST(Task, StackStaysBoundedInALoop)
+{
+  // one worker, so every leaf runs on the same stack
+  auto rt = coco::Runtime(coco::MT, 1);
+  auto range = StackRange();
+  auto sum = std::int64_t(0);
+  rt.block([](StackRange& range, std::int64_t& sum) -> coco::Task<> {
+    for (int i = 0; i < 100000; i++) {
+      sum += co_await leaf(i, range);
+    }
+  }(range, sum));
+  EXPECT_EQ(sum, std::int64_t(100000) * 99999 / 2);
+  // a few frames of slack, one frame per await would be megabytes
+  EXPECT_LT(range.mHigh - range.mLow, 64 * 1024);
+}
+
+TEST(Task, ExceptionsPassTheInlinePath)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto caught = 0;
+  rt.block([](int& caught) -> coco::Task<> {
+    try {
+      co_await []() -> coco::Task<int> {
+        throw std::runtime_error("before suspending");
+        co_return 0;
+      }();
+    } catch (std::runtime_error const&) {
+      caught++;
+    }
+    try {
+      co_await []() -> coco::Task<int> {
+        co_await Requeue();
+        throw std::runtime_error("after suspending");
+        co_return 0;
+      }();
+    } catch (std::runtime_error const&) {
+      caught++;
+    }
+  }(caught));
+  EXPECT_EQ(caught, 2);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#include <gtest/gtest.h>
+
+#include "coco/sys/topology.hpp"
+
+using coco::sys::parseCpuList;
+
+TEST(Topology, ParseCpuList)
+{
+  ASSERT_EQ(parseCpuList("0-3,8,10-11"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+  ASSERT_EQ(parseCpuList("5"), (std::vector<int>{5}));
+  ASSERT_TRUE(parseCpuList("").empty());
+}
+
+TEST(Topology, Detect)
+{
+  auto topology = coco::sys::CpuTopology::detect();
+  ASSERT_FALSE(topology.mNodes.empty());
+  ASSERT_GT(topology.cpuCount(), 0);
+  auto cpu = topology.mNodes.back().front();
+  ASSERT_EQ(topology.nodeOf(cpu), int(topology.mNodes.size() - 1));
+  ASSERT_EQ(topology.nodeOf(-1), -1);
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+#include "coco/sync.hpp"
+
+#include <thread>
+#include <vector>
+
+// yields, sleeps and awaits a child, returns whether it stayed on the thread it started on
+auto staysHome(coco::Runtime& rt) -> coco::Task<bool>
+{
+  auto const home = std::this_thread::get_id();
+  auto same = true;
+  for (int i = 0; i < 10; i++) {
+    co_await coco::Yield();
+    same = same && std::this_thread::get_id() == home;
+    co_await rt.sleepFor(std::chrono::microseconds(100));
+    same = same && std::this_thread::get_id() == home;
+    co_await rt.spawn([]() -> coco::Task<> { co_return; }()).join();
+    same = same && std::this_thread::get_id() == home;
+  }
+  co_return same;
+}
+
+TEST(Tpc, TasksStayOnTheirCore)
+{
+  auto rt = coco::Runtime(coco::TPC, 4);
+  auto results = std::vector<int>(4, 0);
+  rt.block([](coco::Runtime& rt, std::vector<int>& results) -> coco::Task<> {
+    auto handles = std::vector<coco::JoinHandle<coco::Task<bool>>>();
+    for (std::uint32_t core = 0; core < 4; core++) {
+      handles.push_back(rt.spawnOn(core, staysHome(rt)));
+    }
+    for (std::size_t i = 0; i < handles.size(); i++) {
+      co_await handles[i].join();
+      results[i] = handles[i].result();
+    }
+  }(rt, results));
+  ASSERT_EQ(results, std::vector<int>(4, 1));
+}
+
+TEST(Tpc, JoinAcrossCoresReturnsHome)
+{
+  auto rt = coco::Runtime(coco::TPC, 2);
+  auto moved = std::atomic_int(0);
+  rt.block([](coco::Runtime& rt, std::atomic_int& moved) -> coco::Task<> {
+    auto const home = std::this_thread::get_id();
+    for (int i = 0; i < 1000; i++) {
+      co_await rt.spawnOn(1, []() -> coco::Task<> { co_return; }()).join();
+      moved += std::this_thread::get_id() != home;
+    }
+  }(rt, moved));
+  ASSERT_EQ(moved.load(), 0);
+  // every spawn crosses over, the wakeup back only if the child wasn't done before the parent suspended
+  auto tpc = static_cast<coco::TpcExecutor*>(rt.executor());
+  ASSERT_GE(tpc->sent() + tpc->overflows(), 1000);
+  ASSERT_LE(tpc->sent() + tpc->overflows(), 2000);
+}
+
+TEST(Tpc, DetachedSpawnsRunEverywhere)
+{
+  auto rt = coco::Runtime(coco::TPC, 3);
+  auto count = std::atomic_int(0);
+  rt.block([](coco::Runtime& rt, std::atomic_int& count) -> coco::Task<> {
+    auto latch = coco::sync::Latch(300);
+    for (std::uint32_t i = 0; i < 300; i++) {
+      rt.spawnDetachOn(i, [](coco::sync::Latch& latch, std::atomic_int& count) -> coco::Task<> {
+        count++;
+        latch.countDown();
+        co_return;
+      }(latch, count));
+    }
+    co_await latch.wait();
+  }(rt, count));
+  ASSERT_EQ(count.load(), 300);
+}
\ No newline at end of file
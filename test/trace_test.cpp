@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+#include "coco/trace.hpp"
+
+#include <map>
+#include <vector>
+
+auto yieldTwice() -> coco::Task<>
+{
+  co_await coco::Yield();
+  co_await coco::Yield();
+}
+
+auto spawnAndJoin(coco::Runtime& rt, int count) -> coco::Task<>
+{
+  auto handles = std::vector<coco::Runtime::JoinHandle<coco::Task<>>>();
+  for (int i = 0; i < count; i++) {
+    handles.push_back(rt.spawn(yieldTwice()));
+  }
+  for (auto& handle : handles) {
+    co_await handle.join();
+  }
+}
+
+TEST(Trace, RingKeepsTheNewestEvents)
+{
+  coco::Tracer::clear();
+  auto const total = coco::Tracer::kCapacity + 100;
+  for (std::uint64_t i = 0; i < total; i++) {
+    coco::Tracer::record(coco::TraceKind::RoundEnd, nullptr, i, nullptr);
+  }
+  auto events = coco::Tracer::snapshot();
+  ASSERT_EQ(events.size(), coco::Tracer::kCapacity);
+  ASSERT_EQ(events.front().mArg, 100);
+  ASSERT_EQ(events.back().mArg, total - 1);
+  coco::Tracer::clear();
+  ASSERT_TRUE(coco::Tracer::snapshot().empty());
+}
+
+TEST(Trace, TaskLifecycle)
+{
+  coco::Tracer::clear();
+  coco::Tracer::start();
+  {
+    auto rt = coco::Runtime(coco::MT, 2);
+    rt.block(spawnAndJoin(rt, 50));
+  }
+  coco::Tracer::stop();
+  auto events = coco::Tracer::snapshot();
+  if (!coco::kTraceEnabled) {
+    ASSERT_TRUE(events.empty());
+    return;
+  }
+  // every spawned task is created, runs once per yield and finishes
+  auto runs = std::map<std::uint64_t, int>();
+  auto spawned = 0;
+  auto completed = 0;
+  auto awaits = 0;
+  for (auto const& event : events) {
+    spawned += event.mKind == coco::TraceKind::Spawn;
+    completed += event.mKind == coco::TraceKind::Complete;
+    awaits += event.mKind == coco::TraceKind::Await;
+    if (event.mKind == coco::TraceKind::Run) {
+      runs[event.mTask]++;
+    }
+  }
+  ASSERT_GE(spawned, 51);
+  ASSERT_GE(completed, 51);
+  ASSERT_GE(awaits, 150);
+  ASSERT_GE(runs.size(), 50);
+
+  auto json = coco::Tracer::exportChrome();
+  ASSERT_EQ(json.rfind("{\"traceEvents\":[", 0), 0);
+  ASSERT_NE(json.find("Yield"), std::string::npos);
+  ASSERT_NE(json.find("\"name\":\"worker 0\""), std::string::npos);
+  coco::Tracer::clear();
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include "coco/proactor.hpp"
+#include "coco/runtime.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+auto tiny() -> coco::Task<> { co_return; }
+} // namespace
+
+TEST(Wakeup, RunningThreadNeedsNoNotify)
+{
+  auto& proactor = coco::Proactor::get();
+  ASSERT_FALSE(proactor.parked());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_FALSE(proactor.notify());
+  }
+}
+
+TEST(Wakeup, ParkedThreadIsWokenOnce)
+{
+  for (int round = 0; round < 100; round++) {
+    auto parked = std::atomic<coco::Proactor*>(nullptr);
+    auto waiter = std::thread([&parked] {
+      auto& proactor = coco::Proactor::get();
+      parked.store(&proactor);
+      proactor.wait();
+    });
+    coco::Proactor* proactor = nullptr;
+    while ((proactor = parked.load()) == nullptr || !proactor->parked()) {
+      std::this_thread::yield();
+    }
+    // racing notifiers, only one of them pays for the wakeup
+    auto woken = std::atomic_int(0);
+    auto notifiers = std::vector<std::thread>();
+    for (int i = 0; i < 4; i++) {
+      notifiers.emplace_back([proactor, &woken] { woken.fetch_add(int(proactor->notify())); });
+    }
+    for (auto& notifier : notifiers) {
+      notifier.join();
+    }
+    waiter.join();
+    ASSERT_EQ(woken.load(), 1);
+  }
+}
+
+TEST(Wakeup, ParkedWorkersAreAlwaysWoken)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  auto const start = std::chrono::steady_clock::now();
+  rt.block([](coco::Runtime& rt) -> coco::Task<> {
+    for (int i = 0; i < 200; i++) {
+      // long enough for the idle workers to give up spinning
+      co_await rt.sleepFor(1ms);
+      auto handles = std::vector<coco::Runtime::JoinHandle<coco::Task<>>>();
+      for (int j = 0; j < 8; j++) {
+        handles.push_back(rt.spawn(tiny()));
+      }
+      for (auto& handle : handles) {
+        co_await handle.join();
+      }
+    }
+  }(rt));
+  ASSERT_LT(std::chrono::steady_clock::now() - start, 20s);
+}
+
+TEST(Wakeup, NotificationsCoalesce)
+{
+  // without hand-overs, which wake a parked worker once per job
+  auto rt = coco::Runtime(coco::MT, 4, {.mMsgRing = false});
+  constexpr int kTasks = 20'000;
+  rt.block([](coco::Runtime& rt) -> coco::Task<> {
+    auto handles = std::vector<coco::Runtime::JoinHandle<coco::Task<>>>();
+    for (int i = 0; i < kTasks; i++) {
+      handles.push_back(rt.spawn(tiny()));
+    }
+    for (auto& handle : handles) {
+      co_await handle.join();
+    }
+  }(rt));
+  auto stats = rt.stats();
+  if (!stats.mEnabled) {
+    return;
+  }
+  auto total = stats.total();
+  // a park is woken at most once, however many jobs were pushed to it meanwhile
+  ASSERT_LE(total.mUnparks, total.mParks);
+  ASSERT_LT(total.mUnparks, kTasks);
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include "coco/runtime.hpp"
+#include "coco/sync/channel.hpp"
+#include "coco/when.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+// allocations made by the current thread, to check that racing awaiters needs no frames
+static thread_local std::size_t tAllocations = 0;
+auto operator new(std::size_t size) -> void*
+{
+  tAllocations++;
+  if (auto ptr = std::malloc(size); ptr != nullptr) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+auto operator delete(void* ptr) noexcept -> void { std::free(ptr); }
+auto operator delete(void* ptr, std::size_t) noexcept -> void { std::free(ptr); }
+
+auto value(int v) -> coco::Task<int>
+{
+  co_await coco::Yield();
+  co_return v;
+}
+
+auto after(std::chrono::milliseconds delay) -> coco::Runtime::SleepAwaiter
+{
+  return coco::Runtime::SleepAwaiter(std::chrono::steady_clock::now() + delay);
+}
+
+TEST(When, AllCollectsEveryResult)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  rt.block([]() -> coco::Task<> {
+    auto [a, b, c] = co_await coco::whenAll(value(1), value(2), after(1ms));
+    EXPECT_EQ(a, 1);
+    EXPECT_EQ(b, 2);
+    EXPECT_EQ(c, std::monostate());
+  }());
+}
+
+TEST(When, AnyTimesOutAChannelRead)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto channel = coco::sync::Channel<int, 4>();
+  rt.block([](coco::sync::Channel<int, 4>& channel) -> coco::Task<> {
+    auto result = co_await coco::whenAny(channel.read(), after(10ms));
+    EXPECT_EQ(result.index(), 1);
+    // the cancelled reader is gone, the next value goes to the next read
+    co_await channel.write(7);
+    auto read = co_await channel.read();
+    EXPECT_EQ(read, 7);
+  }(channel));
+}
+
+TEST(When, AnyCancelsTheSleep)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto channel = coco::sync::Channel<int, 4>();
+  auto start = std::chrono::steady_clock::now();
+  rt.block([](coco::Runtime& rt, coco::sync::Channel<int, 4>& channel) -> coco::Task<> {
+    rt.spawnDetach([](coco::sync::Channel<int, 4>& channel) -> coco::Task<> {
+      co_await after(10ms);
+      co_await channel.write(42);
+    }(channel));
+    for (int i = 0; i < 2; i++) {
+      auto result = co_await coco::whenAny(after(10s), channel.read());
+      EXPECT_EQ(result.index(), 1);
+      if (result.index() == 1) {
+        EXPECT_EQ(std::get<1>(result), 42);
+      }
+      if (i == 0) {
+        co_await channel.write(42);
+      }
+    }
+  }(rt, channel));
+  ASSERT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+TEST(When, AnyDetachesLosingTasks)
+{
+  auto rt = coco::Runtime(coco::MT, 4);
+  rt.block([]() -> coco::Task<> {
+    auto result = co_await coco::whenAny(
+        []() -> coco::Task<int> {
+          co_await after(50ms);
+          co_return 1;
+        }(),
+        value(2));
+    EXPECT_EQ(result.index(), 1);
+    EXPECT_EQ(std::get<1>(result), 2);
+    co_await after(100ms); // the detached loser finishes and frees itself
+  }());
+}
+
+TEST(When, ReadyBranchNeedsNoAllocation)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto channel = coco::sync::Channel<int, 4>();
+  rt.block([](coco::sync::Channel<int, 4>& channel) -> coco::Task<> {
+    co_await channel.write(5);
+    auto const before = tAllocations;
+    auto result = co_await coco::whenAny(channel.read(), after(10s));
+    EXPECT_EQ(tAllocations, before);
+    EXPECT_EQ(result.index(), 0);
+  }(channel));
+}
+
+TEST(When, AllRethrows)
+{
+  auto rt = coco::Runtime(coco::MT, 2);
+  auto caught = false;
+  rt.block([](bool& caught) -> coco::Task<> {
+    try {
+      co_await coco::whenAll(value(1), []() -> coco::Task<int> {
+        throw std::runtime_error("branch failed");
+        co_return 0;
+      }());
+    } catch (std::runtime_error const&) {
+      caught = true;
+    }
+  }(caught));
+  ASSERT_TRUE(caught);
+}
+
+TEST(When, AnyCancelsASleepWhoseWorkerRetired)
+{
+  auto rt = coco::Runtime(coco::MT, 4, {.mMaxThreads = 4});
+  auto channel = coco::sync::Channel<int, 16>();
+  auto start = std::chrono::steady_clock::now();
+  rt.block([](coco::Runtime& rt, coco::sync::Channel<int, 16>& channel) -> coco::Task<> {
+    auto handles = std::vector<coco::Runtime::JoinHandle<coco::Task<>>>();
+    for (std::uint32_t i = 0; i < 8; i++) {
+      handles.push_back(rt.spawnOn(i % 4, [](coco::sync::Channel<int, 16>& channel) -> coco::Task<> {
+        auto result = co_await coco::whenAny(after(10s), channel.read());
+        EXPECT_EQ(result.index(), 1);
+      }(channel)));
+    }
+    co_await after(20ms);
+    // the sleeps of the retired workers move on to the remaining one, their cancels have to follow
+    rt.setWorkerCount(1);
+    co_await after(20ms);
+    for (int i = 0; i < 8; i++) {
+      co_await channel.write(i);
+    }
+    for (auto& handle : handles) {
+      co_await handle.join();
+    }
+  }(rt, channel));
+  ASSERT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
\ No newline at end of file
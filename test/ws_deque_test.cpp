@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include "coco/util/ws_deque.hpp"
+
+#include <thread>
+#include <vector>
+
+struct Item {
+  int i;
+};
+
+TEST(WsDeque, PushPop)
+{
+  auto deque = coco::util::WsDeque<Item, 4>();
+  auto items = std::vector<Item>{{0}, {1}, {2}, {3}, {4}};
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(deque.push(&items[i]));
+  }
+  ASSERT_FALSE(deque.push(&items[4]));
+  ASSERT_EQ(deque.size(), 4);
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(deque.pop()->i, i);
+  }
+  ASSERT_EQ(deque.pop(), nullptr);
+  ASSERT_TRUE(deque.empty());
+}
+
+TEST(WsDeque, StealHalf)
+{
+  auto victim = coco::util::WsDeque<Item, 16>();
+  auto thief = coco::util::WsDeque<Item, 16>();
+  auto items = std::vector<Item>(9);
+  for (int i = 0; i < 9; i++) {
+    items[i].i = i;
+    ASSERT_TRUE(victim.push(&items[i]));
+  }
+  ASSERT_EQ(victim.stealInto(thief), 5);
+  ASSERT_EQ(victim.size(), 4);
+  for (int i = 0; i < 5; i++) {
+    ASSERT_EQ(thief.pop()->i, i);
+  }
+  ASSERT_EQ(victim.pop()->i, 5);
+}
+
+TEST(WsDeque, Concurrent)
+{
+  constexpr int kCount = 200'000;
+  constexpr int kThieves = 3;
+  auto victim = coco::util::WsDeque<Item, 256>();
+  auto items = std::vector<Item>(kCount);
+  auto seen = std::vector<std::atomic_int>(kCount);
+  auto done = std::atomic_bool(false);
+
+  auto threads = std::vector<std::thread>();
+  for (int t = 0; t < kThieves; t++) {
+    threads.emplace_back([&] {
+      auto local = coco::util::WsDeque<Item, 256>();
+      while (!done.load() || !victim.empty()) {
+        victim.stealInto(local);
+        while (auto item = local.pop()) {
+          seen[item->i].fetch_add(1);
+        }
+      }
+    });
+  }
+  for (int i = 0; i < kCount; i++) {
+    items[i].i = i;
+    while (!victim.push(&items[i])) {
+      if (auto item = victim.pop()) {
+        seen[item->i].fetch_add(1);
+      }
+    }
+  }
+  done = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < kCount; i++) {
+    ASSERT_EQ(seen[i].load(), 1);
+  }
+}
\ No newline at end of file